@@ -0,0 +1,344 @@
+#include "cameraclient.h"
+
+#include <QTimer>
+
+#include <algorithm>
+#include <vector>
+
+static const std::size_t MAX_UNANSWERED = 64;   // SentFrames holds no more
+static const int RETRY_MS = 20;                  // ~2 frame times at 9600 baud
+
+struct CameraClient::Op
+{
+    std::coroutine_handle<> waiter;
+    CommandResult *out = nullptr;           // lives in the awaiting coroutine frame
+    int socket = 0;                         // 0 until ACKed
+    QTimer *timer = nullptr;                // timeout, owned by the client
+    std::unique_ptr<std::stop_callback<std::function<void()>>> onStop;
+};
+
+CameraClient::CameraClient(SendFn sendFn, QObject *parent)
+    : QObject(parent), send(std::move(sendFn))
+{
+}
+
+CameraClient::~CameraClient()
+{
+    // Coroutines still waiting can never resume; free their frames
+    for (auto &op : ops) {
+        op->onStop.reset();
+        op->waiter.destroy();
+    }
+}
+
+// -------------------- Awaitables --------------------
+
+bool CameraClient::Command::await_suspend(std::coroutine_handle<> h)
+{
+    if (stop.stop_requested()) {
+        result = {CommandStatus::Cancelled};
+        return false;
+    }
+    auto owned = std::make_unique<Op>();
+    Op *op = owned.get();
+    op->waiter = h;
+    op->out = &result;
+    client->ops.push_back(std::move(owned));
+
+    client->sending = op;
+    const bool sent = client->send(frame);
+    client->sending = nullptr;
+    if (!sent) {
+        for (auto &u : client->unanswered) if (u.op == op) u.op = nullptr;
+        client->ops.pop_back();
+        result = {CommandStatus::Disconnected};
+        return false;
+    }
+
+    CameraClient *c = client;
+    op->timer = new QTimer(c);
+    op->timer->setSingleShot(true);
+    QObject::connect(op->timer, &QTimer::timeout, c, [c, op] { c->cancel(op, CommandStatus::Timeout); });
+    op->timer->start(timeoutMs);
+    if (stop.stop_possible()) {
+        // request_stop() may come from any thread: hop to ours before touching state
+        op->onStop = std::make_unique<std::stop_callback<std::function<void()>>>(stop, [c, op] {
+            QMetaObject::invokeMethod(c, [c, op] {
+                const bool alive = std::any_of(c->ops.begin(), c->ops.end(),
+                                               [op](const auto &o) { return o.get() == op; });
+                if (alive) c->cancel(op, CommandStatus::Cancelled);
+            }, Qt::QueuedConnection);
+        });
+    }
+    return true;
+}
+
+void CameraClient::Delay::await_suspend(std::coroutine_handle<> h)
+{
+    QTimer::singleShot(ms, client, [h] { h.resume(); });
+}
+
+// -------------------- Commands --------------------
+
+CameraClient::Command CameraClient::command(const visca::RawFrame &f, int timeoutMs, std::stop_token stop)
+{
+    return Command(this, f.withAddress(address), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::recallPreset(int n, int timeoutMs, std::stop_token stop)
+{
+    return command(visca::PresetRecall::encode(address, n), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::storePreset(int n, int timeoutMs, std::stop_token stop)
+{
+    return command(visca::PresetStore::encode(address, n), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::powerOn(int timeoutMs, std::stop_token stop)
+{
+    return command(visca::PowerOn::encode(address), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::powerOff(int timeoutMs, std::stop_token stop)
+{
+    return command(visca::PowerOff::encode(address), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::home(int timeoutMs, std::stop_token stop)
+{
+    return command(visca::PanTiltHome::encode(address), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::zoomTo(int zoom, int timeoutMs, std::stop_token stop)
+{
+    return command(visca::ZoomDirect::encode(address, zoom), timeoutMs, std::move(stop));
+}
+
+CameraClient::Command CameraClient::panTiltTo(int panSpeed, int tiltSpeed, int pan, int tilt,
+                                              int timeoutMs, std::stop_token stop)
+{
+    return command(visca::PanTiltAbsolute::encode(address, panSpeed, tiltSpeed, pan, tilt),
+                   timeoutMs, std::move(stop));
+}
+
+// -------------------- Reply tracking --------------------
+
+void CameraClient::onSent(const char *data, qsizetype size, std::uint64_t seq)
+{
+    if (!seq) return;   // broadcasts and cancels: no reply of their own
+
+    Pending p;
+    p.seq = seq;
+    p.op = data[1] == 0x01 ? sending : nullptr;
+    p.retries = sendingRetries;
+    p.frame.size = std::min<std::size_t>(std::size_t(size), visca::MAX_FRAME);
+    std::copy_n(data, p.frame.size, reinterpret_cast<char *>(p.frame.bytes.data()));
+
+    if (unanswered.size() == MAX_UNANSWERED) unanswered.pop_front();
+    unanswered.push_back(p);
+
+    // Fresh input supersedes a refused frame of the same kind still queued
+    if (!sendingRetries) dropQueued(coalesceKey(p.frame));
+}
+
+// The frame SentFrames paired a reply with; frames sent before it that are
+// still listed got no reply and are forgotten.
+std::optional<CameraClient::Pending> CameraClient::take(std::uint64_t seq)
+{
+    if (!seq) return std::nullopt;
+    while (!unanswered.empty() && unanswered.front().seq < seq) unanswered.pop_front();
+    if (unanswered.empty() || unanswered.front().seq != seq) return std::nullopt;
+    const Pending p = unanswered.front();
+    unanswered.pop_front();
+    return p;
+}
+
+void CameraClient::onReply(const visca::Reply &r, const visca::SentFrame &answered)
+{
+    using visca::ReplyKind;
+    const int s = r.socket;
+    switch (r.kind) {
+    case ReplyKind::Ack: {
+        const std::optional<Pending> taken = take(answered.seq);
+        if (!taken) return;
+        const Pending &p = *taken;
+        if (s <= 0 || s >= MAX_SOCKETS) return;
+        sockets[s] = {true, isMove(p.frame) && !p.cancelOnAck, p.op};
+        if (p.op) p.op->socket = s;
+        if (p.cancelOnAck) send(visca::Cancel::encode(address, s));
+        return;
+    }
+    case ReplyKind::InquiryReply:
+        take(answered.seq);
+        return;
+    case ReplyKind::Error:
+        if (s == 0) {
+            // Rejected before it got a socket: syntax, buffer full, ...
+            const std::optional<Pending> taken = take(answered.seq);
+            if (!taken) return;
+            const Pending &p = *taken;
+            if (r.error == visca::ErrorKind::BufferFull && p.frame.size > 1 && p.frame.bytes[1] == 0x01)
+                refused(p);
+            else if (p.op)
+                finish(p.op, {CommandStatus::Error, r.error});
+        } else if (s < MAX_SOCKETS) {
+            Op *op = sockets[s].op;
+            release(s);
+            if (op)
+                finish(op, {r.error == visca::ErrorKind::Cancelled ? CommandStatus::Cancelled
+                                                                    : CommandStatus::Error,
+                            r.error});
+        }
+        return;
+    case ReplyKind::Completion:
+        if (s > 0 && s < MAX_SOCKETS) {
+            Op *op = sockets[s].op;
+            release(s);
+            if (op) finish(op, {CommandStatus::Completed});
+        }
+        return;
+    default:
+        return;
+    }
+}
+
+void CameraClient::reset()
+{
+    unanswered.clear();
+    retryQueue.clear();
+    if (retryTimer) retryTimer->stop();
+    std::fill(std::begin(sockets), std::end(sockets), Running{});
+    while (!ops.empty()) finish(ops.front().get(), {CommandStatus::Disconnected});
+}
+
+int CameraClient::preempt()
+{
+    int n = 0;
+    for (int s = 1; s < MAX_SOCKETS; ++s) {
+        if (!sockets[s].busy || !sockets[s].move) continue;
+        sockets[s].move = false;               // one Cancel per socket
+        send(visca::Cancel::encode(address, s));
+        ++n;
+    }
+    for (auto &p : unanswered) {
+        if (p.cancelOnAck || !isMove(p.frame)) continue;
+        p.cancelOnAck = true;
+        ++n;
+    }
+    std::vector<Op *> dropped;
+    for (auto it = retryQueue.begin(); it != retryQueue.end();) {
+        if (!isMove(it->frame)) { ++it; continue; }
+        if (it->op) dropped.push_back(it->op);
+        it = retryQueue.erase(it);
+        ++n;
+    }
+    count.preempted += quint64(n);
+    // Resume waiters only once our own bookkeeping is consistent
+    for (Op *op : dropped) finish(op, {CommandStatus::Cancelled});
+    return n;
+}
+
+// -------------------- Backpressure --------------------
+
+void CameraClient::release(int socket)
+{
+    sockets[socket] = Running{};
+    resend();   // a socket is free: the oldest refused frame goes first
+}
+
+void CameraClient::refused(const Pending &p)
+{
+    if (p.retries >= MAX_RETRIES) {
+        ++count.refused;
+        if (p.op) finish(p.op, {CommandStatus::Error, visca::ErrorKind::BufferFull});
+        return;
+    }
+    dropQueued(coalesceKey(p.frame));
+    retryQueue.push_back(p);
+    if (!retryTimer) {
+        retryTimer = new QTimer(this);
+        retryTimer->setSingleShot(true);
+        connect(retryTimer, &QTimer::timeout, this, &CameraClient::resend);
+    }
+    if (!retryTimer->isActive()) retryTimer->start(RETRY_MS);
+}
+
+void CameraClient::resend()
+{
+    if (retryQueue.empty()) return;
+    const Pending p = retryQueue.front();
+    retryQueue.pop_front();
+    sending = p.op;
+    sendingRetries = p.retries + 1;
+    const bool sent = send(p.frame);
+    sending = nullptr;
+    sendingRetries = 0;
+    if (sent) ++count.retried;
+    else if (p.op) finish(p.op, {CommandStatus::Disconnected});
+    if (!retryQueue.empty() && retryTimer) retryTimer->start(RETRY_MS);
+}
+
+void CameraClient::dropQueued(int key)
+{
+    if (!key) return;
+    std::vector<Op *> stale;
+    for (auto it = retryQueue.begin(); it != retryQueue.end();) {
+        if (coalesceKey(it->frame) != key) { ++it; continue; }
+        if (it->op) stale.push_back(it->op);
+        it = retryQueue.erase(it);
+    }
+    for (Op *op : stale) finish(op, {CommandStatus::Error, visca::ErrorKind::BufferFull});
+}
+
+bool CameraClient::isMove(const visca::RawFrame &f)
+{
+    if (f.size < 5 || f.bytes[1] != 0x01) return false;
+    const auto cat = f.bytes[2], cmd = f.bytes[3];
+    return (cat == 0x04 && cmd == 0x3F && f.bytes[4] == 0x02)   // preset recall
+        || (cat == 0x04 && cmd == 0x47)                          // zoom direct
+        || (cat == 0x06 && (cmd == 0x02 || cmd == 0x03 || cmd == 0x04));   // absolute, relative, home
+}
+
+// Frames where only the newest matters: 1 = pan/tilt drive, 2 = variable zoom
+int CameraClient::coalesceKey(const visca::RawFrame &f)
+{
+    if (f.size < 5 || f.bytes[1] != 0x01) return 0;
+    if (f.bytes[2] == 0x06 && f.bytes[3] == 0x01) return 1;
+    if (f.bytes[2] == 0x04 && f.bytes[3] == 0x07) return 2;
+    return 0;
+}
+
+// -------------------- Timeouts / cancellation --------------------
+
+void CameraClient::cancel(Op *op, CommandStatus why)
+{
+    if (op->socket) {
+        send(visca::Cancel::encode(address, op->socket));
+    } else {
+        // Not ACKed yet: cancel it as soon as its socket is known
+        for (auto &u : unanswered)
+            if (u.op == op) u.cancelOnAck = true;
+    }
+    finish(op, {why});
+}
+
+void CameraClient::finish(Op *op, CommandResult result)
+{
+    for (auto &u : unanswered)
+        if (u.op == op) u.op = nullptr;
+    std::erase_if(retryQueue, [op](const Pending &p) { return p.op == op; });
+    if (op->socket && sockets[op->socket].op == op) sockets[op->socket].op = nullptr;
+
+    if (op->timer) {
+        op->timer->stop();
+        op->timer->deleteLater();   // may be inside its own timeout signal
+    }
+
+    *op->out = result;
+    const std::coroutine_handle<> h = op->waiter;
+    auto it = std::find_if(ops.begin(), ops.end(), [op](const auto &o) { return o.get() == op; });
+    ops.erase(it);   // drops the stop callback
+    // Resume last: the coroutine may send more commands through us
+    h.resume();
+}
@@ -0,0 +1,185 @@
+#ifndef CAMERACLIENT_H
+#define CAMERACLIENT_H
+
+// Awaitable camera commands.
+//
+// Every frame MainWindow sends passes through onSent() and every decoded
+// reply through onReply(), so the client follows each command from ACK
+// (which names its socket) to completion or error; the link's
+// visca::SentFrames says which frame an ACK or socket-0 error answers.
+// Commands issued through the client can be awaited from a coroutine running
+// on the Qt event loop:
+//
+//     CameraClient::Job MainWindow::tour(std::stop_token stop)
+//     {
+//         if (auto r = co_await cam->recallPreset(3, 8000, stop); !r) co_return;
+//         co_await cam->delay(2000);
+//         co_await cam->recallPreset(4, 8000, stop);
+//     }
+//
+// The awaiting coroutine resumes on the GUI thread with a CommandResult:
+// completed, the camera's error, a timeout, cancellation through the stop
+// token (a running command is also cancelled on the camera, 8x 2p FF) or
+// a disconnect.
+//
+// The client also knows which command holds each socket. preempt() cancels
+// running moves (preset recall, absolute, home, zoom direct) so a manual
+// drive is not stuck behind them or refused with "buffer full". Commands
+// that are refused anyway are resent as soon as a socket frees up; a newer
+// drive or zoom frame replaces a queued one, so the latest input wins.
+
+#include <QObject>
+
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+
+#include "viscareply.h"
+
+class QTimer;
+
+enum class CommandStatus { Completed, Error, Timeout, Cancelled, Disconnected };
+
+struct CommandResult
+{
+    CommandStatus    status = CommandStatus::Completed;
+    visca::ErrorKind error = visca::ErrorKind::None;   // set for Error
+    explicit operator bool() const { return status == CommandStatus::Completed; }
+};
+
+class CameraClient : public QObject
+{
+    Q_OBJECT
+    struct Op;
+public:
+    static const int DEFAULT_TIMEOUT_MS = 10000;   // ACK through completion
+
+    // Fire-and-forget coroutine type for sequences; starts immediately and
+    // frees itself when it returns.
+    struct Job
+    {
+        struct promise_type
+        {
+            Job get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    class Command
+    {
+    public:
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> h);
+        CommandResult await_resume() const { return result; }
+    private:
+        friend class CameraClient;
+        Command(CameraClient *c, const visca::RawFrame &f, int timeoutMs, std::stop_token stop)
+            : client(c), frame(f), timeoutMs(timeoutMs), stop(std::move(stop)) {}
+        CameraClient   *client;
+        visca::RawFrame frame;
+        int             timeoutMs;
+        std::stop_token stop;
+        CommandResult   result;
+    };
+
+    class Delay
+    {
+    public:
+        bool await_ready() const { return ms <= 0; }
+        void await_suspend(std::coroutine_handle<> h);
+        void await_resume() const {}
+    private:
+        friend class CameraClient;
+        Delay(CameraClient *c, int ms) : client(c), ms(ms) {}
+        CameraClient *client;
+        int ms;
+    };
+
+    // `send` writes a frame and returns false when the camera is not connected.
+    using SendFn = std::function<bool(const visca::RawFrame &)>;
+
+    explicit CameraClient(SendFn send, QObject *parent = nullptr);
+    ~CameraClient() override;
+
+    void setAddress(int a) { address = a; }
+
+    Command command(const visca::RawFrame &f, int timeoutMs = DEFAULT_TIMEOUT_MS,
+                    std::stop_token stop = {});
+    Command recallPreset(int n, int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Command storePreset(int n, int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Command powerOn(int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Command powerOff(int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Command home(int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Command zoomTo(int zoom, int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Command panTiltTo(int panSpeed, int tiltSpeed, int pan, int tilt,
+                      int timeoutMs = DEFAULT_TIMEOUT_MS, std::stop_token stop = {});
+    Delay delay(int ms) { return Delay(this, ms); }
+
+    // Traffic hooks, called by MainWindow for every frame in either
+    // direction; `seq` and `answered` come from its SentFrames.
+    void onSent(const char *data, qsizetype size, std::uint64_t seq);
+    void onReply(const visca::Reply &r, const visca::SentFrame &answered);
+    // Port closed: everything outstanding resolves as Disconnected.
+    void reset();
+
+    // Cancels running and not-yet-ACKed moves; returns how many.
+    int preempt();
+
+    struct Counters {
+        quint64 preempted = 0;    // moves cancelled for manual control
+        quint64 retried = 0;      // frames resent after buffer full
+        quint64 refused = 0;      // frames given up after MAX_RETRIES
+    };
+    const Counters &counters() const { return count; }
+
+private:
+    static const int MAX_SOCKETS = 16;
+    static const int MAX_RETRIES = 3;
+
+    // A sent frame still waiting for its ACK, error or inquiry reply
+    struct Pending
+    {
+        std::uint64_t seq = 0;      // SentFrame::seq of the send
+        Op  *op = nullptr;          // nullptr: not ours, or already given up
+        bool cancelOnAck = false;   // given up before ACK: cancel once it runs
+        int  retries = 0;
+        visca::RawFrame frame;      // kept for resending after buffer full
+    };
+
+    // Command holding a socket between ACK and completion
+    struct Running
+    {
+        bool busy = false;
+        bool move = false;          // preemptible by manual control
+        Op  *op = nullptr;
+    };
+
+    std::optional<Pending> take(std::uint64_t seq);
+    void finish(Op *op, CommandResult result);
+    void cancel(Op *op, CommandStatus why);   // timeout or stop token
+    void release(int socket);                 // completion or error on a socket
+    void refused(const Pending &p);           // buffer full
+    void resend();
+    void dropQueued(int key);                 // coalesceKey; 0 = nothing
+    static bool isMove(const visca::RawFrame &f);
+    static int  coalesceKey(const visca::RawFrame &f);
+
+    SendFn send;
+    int address = 1;
+    Op *sending = nullptr;                  // op whose frame is being written
+    int sendingRetries = 0;                 // retry count of the frame being written
+    std::deque<Pending> unanswered;         // one per tracked frame, by seq
+    Running sockets[MAX_SOCKETS]{};
+    std::deque<Pending> retryQueue;         // refused frames waiting for a socket
+    QTimer *retryTimer = nullptr;           // fallback when no socket frees up
+    std::deque<std::unique_ptr<Op>> ops;    // ownership of outstanding ops
+    Counters count;
+};
+
+#endif // CAMERACLIENT_H
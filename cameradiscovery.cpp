@@ -0,0 +1,158 @@
+#include "cameradiscovery.h"
+
+#include <QSerialPort>
+#include <QSerialPortInfo>
+
+#include <array>
+
+// Most likely first: Sony's default, then its alternative, then others seen on clones
+static const std::array<int, 4> BAUDS{9600, 38400, 19200, 115200};
+
+QString DiscoveredCamera::identity() const
+{
+    auto hex4 = [](int v) { return QString("%1").arg(v & 0xFFFF, 4, 16, QLatin1Char('0')).toUpper(); };
+    return QString("%1|%2:%3:%4|%5").arg(adapterSerial, hex4(version.vendor), hex4(version.model),
+                                         hex4(version.rom)).arg(address);
+}
+
+int DiscoveredCamera::matchScore(const QString &stored) const
+{
+    const QStringList want = stored.split('|');
+    const QStringList have = identity().split('|');
+    if (want.size() != 3 || have.size() != 3) return 0;
+    const bool sameAdapter = !want[0].isEmpty() && want[0] == have[0];
+    const bool sameCamera = want[1] == have[1];
+    const bool sameAddress = want[2] == have[2];
+    if (!sameAdapter && !sameCamera) return 0;
+    return (sameAdapter ? 4 : 0) + (sameCamera ? 2 : 0) + (sameAddress ? 1 : 0);
+}
+
+bool DiscoveredCamera::autoSelectable(const QString &stored) const
+{
+    const QString adapter = stored.section('|', 0, 0);
+    return adapter.isEmpty() || adapter == adapterSerial;
+}
+
+QString CameraDiscovery::adapterSerial(const QString &port)
+{
+    // QSerialPortInfo(name) only matches portName(), not the /dev path we list
+    for (const QSerialPortInfo &info : QSerialPortInfo::availablePorts())
+        if (info.portName() == port || info.systemLocation() == port) return info.serialNumber();
+    return {};
+}
+
+CameraDiscovery::CameraDiscovery(QObject *parent)
+    : QObject(parent)
+{
+}
+
+CameraDiscovery::~CameraDiscovery()
+{
+    cancel();
+}
+
+void CameraDiscovery::scan(const QStringList &ports)
+{
+    cancel();
+    results.clear();
+    clock.start();
+
+    for (const QString &name : ports) {
+        auto *p = new Probe;
+        p->name = name;
+        p->adapterSerial = adapterSerial(name);
+        p->port = new QSerialPort(this);
+        p->port->setPortName(name);
+        p->port->setBaudRate(BAUDS[0]);
+        if (!p->port->open(QIODevice::ReadWrite)) {   // busy or not ours to open
+            delete p->port;
+            delete p;
+            continue;
+        }
+        p->timer = new QTimer(this);
+        p->timer->setSingleShot(true);
+        connect(p->port, &QSerialPort::readyRead, this, [this, p] { onReadyRead(p); });
+        connect(p->timer, &QTimer::timeout, this, [this, p] { onTimeout(p); });
+        probes << p;
+        sendProbe(p);
+    }
+    if (probes.isEmpty()) emit finished(results, int(clock.elapsed()));
+}
+
+void CameraDiscovery::cancel()
+{
+    for (Probe *p : std::as_const(probes)) {
+        p->port->close();
+        p->port->deleteLater();
+        p->timer->deleteLater();
+        delete p;
+    }
+    probes.clear();
+}
+
+void CameraDiscovery::sendProbe(Probe *p)
+{
+    QByteArray out;
+    const auto clear = visca::IfClear::encode(visca::BROADCAST);
+    out.append(clear.data(), qsizetype(clear.size()));
+    for (int a = 1; a <= 7; ++a) {
+        const auto inq = visca::VersionInq::encode(a);
+        out.append(inq.data(), qsizetype(inq.size()));
+    }
+    p->rx.clear();
+    p->port->clear();
+    p->port->write(out);
+    p->timer->start(PROBE_MS);
+}
+
+void CameraDiscovery::onReadyRead(Probe *p)
+{
+    p->rx += p->port->readAll();
+    const auto *data = reinterpret_cast<const visca::Byte *>(p->rx.constData());
+    qsizetype start = 0;
+    while (true) {
+        const qsizetype end = p->rx.indexOf(char(0xFF), start);
+        if (end < 0) break;
+        const std::size_t len = std::size_t(end - start + 1);
+        const visca::Reply r = visca::decode(data + start, len, visca::Inquiry::Version);
+        start = end + 1;
+
+        DiscoveredCamera c;
+        c.port = p->name;
+        c.adapterSerial = p->adapterSerial;
+        c.baud = BAUDS[std::size_t(p->baudIndex)];
+        if (r.kind == visca::ReplyKind::InquiryReply) {
+            c.address = r.address;
+            c.version = r.version;
+            // An earlier IF_Clear-only entry is superseded by a real reply
+            p->found.removeIf([](const DiscoveredCamera &d) { return d.address == 0; });
+            p->found << c;
+        } else if (r.kind == visca::ReplyKind::IfClear && p->found.isEmpty()) {
+            c.address = 0;
+            p->found << c;
+        }
+    }
+    if (start > 0) p->rx.remove(0, start);
+}
+
+void CameraDiscovery::onTimeout(Probe *p)
+{
+    if (!p->found.isEmpty() || p->baudIndex + 1 >= int(BAUDS.size())) {
+        done(p);
+        return;
+    }
+    ++p->baudIndex;
+    p->port->setBaudRate(BAUDS[std::size_t(p->baudIndex)]);
+    sendProbe(p);
+}
+
+void CameraDiscovery::done(Probe *p)
+{
+    results += p->found;
+    probes.removeOne(p);
+    p->port->close();
+    p->port->deleteLater();
+    p->timer->deleteLater();   // we are inside its timeout
+    delete p;
+    if (probes.isEmpty()) emit finished(results, int(clock.elapsed()));
+}
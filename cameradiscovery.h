@@ -0,0 +1,84 @@
+#ifndef CAMERADISCOVERY_H
+#define CAMERADISCOVERY_H
+
+// Finds VISCA cameras on the machine's serial ports.
+//
+// Every candidate port is opened at once and probed in parallel: IF_Clear
+// (broadcast) plus a version inquiry to each address 1..7, pipelined in one
+// write. A port that stays silent for PROBE_MS is retried at the next baud
+// rate; one that answers is done after that window. With cameras at the
+// usual 9600 baud a scan takes ~150 ms regardless of the number of ports.
+//
+// A camera is identified by the USB adapter's serial number (stable when
+// port names are not) plus its version reply and daisy-chain address.
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QTimer>
+
+#include "viscareply.h"
+
+class QSerialPort;
+
+struct DiscoveredCamera
+{
+    QString port;
+    QString adapterSerial;          // QSerialPortInfo::serialNumber(), may be empty
+    int     baud = 9600;
+    int     address = 1;            // 0 = answered IF_Clear but not the version inquiry
+    visca::Version version;
+
+    // "serial|vendor:model:rom|address", kept per profile
+    QString identity() const;
+    // 0 = different camera; higher is a closer match to a stored identity
+    int matchScore(const QString &identity) const;
+    // Whether it may be used without asking: an identity that names an
+    // adapter only accepts cameras on that adapter
+    bool autoSelectable(const QString &identity) const;
+};
+
+class CameraDiscovery : public QObject
+{
+    Q_OBJECT
+public:
+    static const int PROBE_MS = 150;
+
+    explicit CameraDiscovery(QObject *parent = nullptr);
+    ~CameraDiscovery() override;
+
+    // USB serial number of the adapter behind a port, found by portName()
+    // ("COM4") or systemLocation() ("/dev/ttyUSB0"); empty if it has none.
+    static QString adapterSerial(const QString &port);
+
+    void scan(const QStringList &ports);
+    void cancel();
+    bool isRunning() const { return !probes.isEmpty(); }
+
+signals:
+    void finished(const QList<DiscoveredCamera> &cameras, int elapsedMs);
+
+private:
+    struct Probe
+    {
+        QSerialPort *port = nullptr;
+        QString      name;
+        QString      adapterSerial;
+        int          baudIndex = 0;
+        QByteArray   rx;
+        QTimer      *timer = nullptr;
+        QList<DiscoveredCamera> found;
+    };
+
+    void sendProbe(Probe *p);
+    void onReadyRead(Probe *p);
+    void onTimeout(Probe *p);
+    void done(Probe *p);
+
+    QList<Probe *> probes;
+    QList<DiscoveredCamera> results;
+    QElapsedTimer clock;
+};
+
+#endif // CAMERADISCOVERY_H
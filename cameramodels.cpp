@@ -0,0 +1,62 @@
+#include "cameramodels.h"
+
+#include <array>
+
+static constexpr unsigned ALL_INQUIRIES =
+    FEAT_PAN_TILT_POS_INQ | FEAT_ZOOM_POS_INQ | FEAT_FOCUS_INQ | FEAT_AE_MODE_INQ;
+static constexpr unsigned STANDARD_MOTION = FEAT_ABSOLUTE_PT | FEAT_ZOOM_DIRECT | FEAT_CANCEL;
+
+const CameraModel GENERIC_CAMERA = {
+    "Generic VISCA", 0, 0,
+    0x18, 0x14, 7, 16,
+    ALL_INQUIRIES | STANDARD_MOTION,
+    3, 1000, 8000,
+    -0x7FFF, 0x7FFF, -0x7FFF, 0x7FFF, 0x4000,
+    1000, 1000, 0x4000 / 3,
+};
+
+// Vendor/model codes and limits from the Sony command lists. Add rows as new
+// cameras show up in the field; order does not matter.
+static const std::array<CameraModel, 3> MODELS = {{
+    {"Sony EVI-D30", 0x0001, 0x0402,
+     0x18, 0x14, 7, 6,
+     FEAT_PAN_TILT_POS_INQ | FEAT_ZOOM_POS_INQ | FEAT_FOCUS_INQ | FEAT_ABSOLUTE_PT
+         | FEAT_ZOOM_DIRECT | FEAT_CANCEL,
+     2, 1000, 6000,
+     -880, 880, -300, 300, 0x03FF,
+     700, 600, 0x03FF / 2},
+    {"Sony EVI-D100", 0x0001, 0x040D,
+     0x18, 0x14, 7, 6,
+     ALL_INQUIRIES | STANDARD_MOTION,
+     3, 1000, 8000,
+     -1440, 1440, -360, 360, 0x4000,
+     4300, 1800, 0x4000 / 2},
+    {"Sony EVI-D70", 0x0001, 0x040E,
+     0x18, 0x17, 7, 6,
+     ALL_INQUIRIES | STANDARD_MOTION,
+     3, 1000, 10000,
+     -2267, 2267, -400, 1200, 0x4000,
+     1330, 1200, 0x4000 / 2},
+}};
+
+const CameraModel &lookupCameraModel(const visca::Version &v)
+{
+    for (const CameraModel &m : MODELS)
+        if ((!m.vendor || m.vendor == v.vendor) && (!m.model || m.model == v.model))
+            return m;
+    return GENERIC_CAMERA;
+}
+
+bool supportsInquiry(const CameraModel &m, visca::Inquiry q)
+{
+    switch (q) {
+    case visca::Inquiry::Power:
+    case visca::Inquiry::Version:    return true;
+    case visca::Inquiry::ZoomPos:    return m.features & FEAT_ZOOM_POS_INQ;
+    case visca::Inquiry::FocusMode:
+    case visca::Inquiry::FocusPos:   return m.features & FEAT_FOCUS_INQ;
+    case visca::Inquiry::AeMode:     return m.features & FEAT_AE_MODE_INQ;
+    case visca::Inquiry::PanTiltPos: return m.features & FEAT_PAN_TILT_POS_INQ;
+    default:                         return false;
+    }
+}
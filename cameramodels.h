@@ -0,0 +1,53 @@
+#ifndef CAMERAMODELS_H
+#define CAMERAMODELS_H
+
+// Per-model capabilities, selected from the CAM_VersionInq reply
+// (y0 50 GG GG HH HH JJ JJ KK FF: vendor, model, ROM, sockets).
+//
+// Unknown cameras get GENERIC, which matches what the app always assumed:
+// pan 1..0x18, tilt 1..0x14, 16 presets, and every inquiry and motion
+// command tried (an unsupported one just costs a syntax error).
+
+#include "viscareply.h"
+
+#include <cstdint>
+
+enum CameraFeature : unsigned {
+    FEAT_PAN_TILT_POS_INQ = 1u << 0,   // 8x 09 06 12 FF
+    FEAT_ZOOM_POS_INQ     = 1u << 1,   // 8x 09 04 47 FF
+    FEAT_FOCUS_INQ        = 1u << 2,   // 8x 09 04 38/48 FF
+    FEAT_AE_MODE_INQ      = 1u << 3,   // 8x 09 04 39 FF
+    FEAT_ABSOLUTE_PT      = 1u << 4,   // 8x 01 06 02 ... FF
+    FEAT_ZOOM_DIRECT      = 1u << 5,   // 8x 01 04 47 ... FF
+    FEAT_CANCEL           = 1u << 6,   // 8x 2y FF
+};
+
+struct CameraModel
+{
+    const char   *name;
+    std::uint16_t vendor;          // 0 = any
+    std::uint16_t model;           // 0 = any
+    int           panSpeedMax;     // VV of Pan-tiltDrive
+    int           tiltSpeedMax;    // WW of Pan-tiltDrive
+    int           zoomSpeedMax;    // p of Zoom Tele/Wide (variable)
+    int           presetCount;
+    unsigned      features;        // CameraFeature bits
+    int           inquiryWindow;   // inquiries kept in flight at once
+    int           replyTimeoutMs;  // ACK/inquiry reply deadline
+    int           bootMs;          // power-on to ready, typical
+    int           panMin, panMax;  // absolute position range, camera units
+    int           tiltMin, tiltMax;
+    int           zoomMax;         // optical tele end
+    int           panRate;         // units/s at panSpeedMax (speed codes ~linear)
+    int           tiltRate;        // units/s at tiltSpeedMax
+    int           zoomRate;        // units/s at zoomSpeedMax
+};
+
+extern const CameraModel GENERIC_CAMERA;
+
+const CameraModel &lookupCameraModel(const visca::Version &v);
+
+// Inquiries a model answers; unsupported ones cost a syntax-error round-trip.
+bool supportsInquiry(const CameraModel &m, visca::Inquiry q);
+
+#endif // CAMERAMODELS_H
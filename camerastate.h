@@ -0,0 +1,107 @@
+#ifndef CAMERASTATE_H
+#define CAMERASTATE_H
+
+// Last known state of the connected camera, filled from inquiry replies.
+
+#include "viscareply.h"
+
+#include <array>
+#include <cstdint>
+
+struct CameraState
+{
+    bool             powerKnown = false;
+    bool             powerOn = false;
+    bool             versionKnown = false;
+    visca::Version   version;
+    bool             zoomKnown = false;
+    int              zoom = 0;
+    bool             focusKnown = false;
+    int              focus = 0;
+    visca::FocusMode focusMode = visca::FocusMode::Unknown;
+    visca::AeMode    aeMode = visca::AeMode::Unknown;
+    bool             panTiltKnown = false;
+    int              pan = 0;
+    int              tilt = 0;
+
+    // Returns true if the reply carried state.
+    bool apply(const visca::Reply &r)
+    {
+        if (r.kind != visca::ReplyKind::InquiryReply) return false;
+        switch (r.inquiry) {
+        case visca::Inquiry::Power:      powerKnown = true; powerOn = r.powerOn; break;
+        case visca::Inquiry::Version:    versionKnown = true; version = r.version; break;
+        case visca::Inquiry::ZoomPos:    zoomKnown = true; zoom = r.zoom; break;
+        case visca::Inquiry::FocusPos:   focusKnown = true; focus = r.focus; break;
+        case visca::Inquiry::FocusMode:  focusMode = r.focusMode; break;
+        case visca::Inquiry::AeMode:     aeMode = r.aeMode; break;
+        case visca::Inquiry::PanTiltPos: panTiltKnown = true; pan = r.pan; tilt = r.tilt; break;
+        default: return false;
+        }
+        return true;
+    }
+
+    // Compact form for the warm-start cache: format byte, known/power
+    // flags, version, then the positions little-endian. A layout change
+    // bumps PACK_FORMAT so old entries are ignored rather than misread.
+    static constexpr std::uint8_t PACK_FORMAT = 1;
+    static constexpr std::size_t  PACKED_SIZE = 23;
+    using Packed = std::array<std::uint8_t, PACKED_SIZE>;
+
+    Packed pack() const
+    {
+        Packed p{};
+        std::size_t i = 0;
+        auto put = [&](std::uint32_t v, int bytes) {
+            for (int b = 0; b < bytes; ++b) p[i++] = std::uint8_t(v >> (8 * b));
+        };
+        put(PACK_FORMAT, 1);
+        put(std::uint32_t(powerKnown) | std::uint32_t(powerOn) << 1 | std::uint32_t(versionKnown) << 2
+                | std::uint32_t(zoomKnown) << 3 | std::uint32_t(focusKnown) << 4
+                | std::uint32_t(panTiltKnown) << 5, 1);
+        put(version.vendor, 2);
+        put(version.model, 2);
+        put(version.rom, 2);
+        put(version.sockets, 1);
+        put(std::uint32_t(zoom), 2);
+        put(std::uint32_t(focus), 2);
+        put(std::uint32_t(focusMode), 1);
+        put(std::uint32_t(aeMode), 1);
+        put(std::uint32_t(pan), 4);
+        put(std::uint32_t(tilt), 4);
+        return p;
+    }
+
+    static bool unpack(const std::uint8_t *p, std::size_t size, CameraState &out)
+    {
+        if (size != PACKED_SIZE || p[0] != PACK_FORMAT) return false;
+        std::size_t i = 1;
+        auto get = [&](int bytes) {
+            std::uint32_t v = 0;
+            for (int b = 0; b < bytes; ++b) v |= std::uint32_t(p[i++]) << (8 * b);
+            return v;
+        };
+        CameraState s;
+        const std::uint32_t flags = get(1);
+        s.powerKnown = flags & 1;
+        s.powerOn = flags & 2;
+        s.versionKnown = flags & 4;
+        s.zoomKnown = flags & 8;
+        s.focusKnown = flags & 16;
+        s.panTiltKnown = flags & 32;
+        s.version.vendor = std::uint16_t(get(2));
+        s.version.model = std::uint16_t(get(2));
+        s.version.rom = std::uint16_t(get(2));
+        s.version.sockets = visca::Byte(get(1));
+        s.zoom = int(get(2));
+        s.focus = int(get(2));
+        s.focusMode = visca::FocusMode(get(1));
+        s.aeMode = visca::AeMode(get(1));
+        s.pan = std::int32_t(get(4));
+        s.tilt = std::int32_t(get(4));
+        out = s;
+        return true;
+    }
+};
+
+#endif // CAMERASTATE_H
@@ -0,0 +1,376 @@
+#include "captureindex.h"
+#include "gzip.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <cstring>
+
+static const quint8 NO_ARG = 0xFF;
+
+static const char *TYPE_NAMES[] = {
+    "other", "recall", "store", "ptz", "zoom", "focus", "power", "inquiry", "cancel", "clear",
+    "ack", "done", "reply", "error", "address", "event",
+};
+static_assert(std::size(TYPE_NAMES) == std::size_t(CaptureIndex::Type::Count));
+
+struct ErrorName { quint8 code; const char *name; };
+static const ErrorName ERROR_NAMES[] = {
+    {0x01, "message_length"}, {0x02, "syntax"}, {0x03, "buffer_full"}, {0x04, "cancelled"},
+    {0x05, "no_socket"}, {0x41, "not_executable"},
+};
+
+const char *CaptureIndex::typeName(Type t)
+{
+    return TYPE_NAMES[std::size_t(t)];
+}
+
+// -------------------- Loading --------------------
+
+void CaptureIndex::clear()
+{
+    entries.clear();
+    pool.clear();
+    for (auto &l : byType) l.clear();
+    lastDate.clear();
+}
+
+bool CaptureIndex::load(const QStringList &files, QString *error)
+{
+    for (const QString &f : files) {
+        QByteArray data;
+        QFile file(f);
+        if (!file.open(QIODevice::ReadOnly)) {
+            if (error) *error = QString("cannot open %1").arg(f);
+            return false;
+        }
+        data = file.readAll();
+        if (f.endsWith(".gz")) {
+            QByteArray plain;
+            QString why;
+            if (!gzip::decompress(data, plain, &why)) {
+                if (error) *error = QString("cannot decompress %1: %2").arg(QFileInfo(f).fileName(), why);
+                return false;
+            }
+            data = std::move(plain);
+        }
+
+        entries.reserve(entries.size() + std::size_t(data.size() / 40));   // ~40 bytes per line
+        const char *p = data.constData();
+        const char *end = p + data.size();
+        while (p < end) {
+            const char *nl = static_cast<const char *>(std::memchr(p, '\n', std::size_t(end - p)));
+            const char *eol = nl ? nl : end;
+            if (eol > p) addLine(p, eol - p);
+            p = eol + 1;
+        }
+    }
+    return true;
+}
+
+static int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static int twoDigits(const char *s)
+{
+    return (s[0] - '0') * 10 + (s[1] - '0');
+}
+
+static void classify(CaptureIndex::Entry &e, const quint8 *b, int n)
+{
+    using Type = CaptureIndex::Type;
+    e.type = Type::Other;
+    e.arg = NO_ARG;
+    if (n < 3) return;
+
+    if (b[0] == 0x88) {
+        e.address = 8;
+        if (b[1] == 0x01 && n >= 5 && b[2] == 0x00 && b[3] == 0x01) e.type = Type::IfClear;
+        else if (b[1] == 0x30) { e.type = Type::AddressSet; e.arg = b[2] & 0x0F; }
+        return;
+    }
+
+    if (e.dir == CaptureIndex::Dir::Tx) {
+        e.address = b[0] & 0x0F;
+        if ((b[1] & 0xF0) == 0x20) { e.type = Type::Cancel; e.arg = b[1] & 0x0F; return; }
+        if (b[1] == 0x09) { e.type = Type::Inquiry; return; }
+        if (b[1] != 0x01 || n < 5) return;
+        if (b[2] == 0x06) { e.type = Type::PanTilt; return; }
+        if (b[2] != 0x04) return;
+        switch (b[3]) {
+        case 0x3F:
+            if (n >= 7 && (b[4] == 0x01 || b[4] == 0x02)) {
+                e.type = b[4] == 0x02 ? Type::Recall : Type::Store;
+                e.arg = b[5];
+            }
+            break;
+        case 0x07: case 0x47:
+            e.type = Type::Zoom;
+            break;
+        case 0x08: case 0x18: case 0x28: case 0x38: case 0x48:
+            e.type = Type::Focus;
+            break;
+        case 0x00:
+            e.type = Type::Power;
+            break;
+        }
+        return;
+    }
+
+    e.address = quint8(b[0] >= 0x90 && b[0] <= 0xF0 ? (b[0] >> 4) - 8 : 0);
+    switch (b[1] & 0xF0) {
+    case 0x40:
+        e.type = Type::Ack;
+        e.arg = b[1] & 0x0F;
+        break;
+    case 0x50:
+        if (n == 3) { e.type = Type::Completion; e.arg = b[1] & 0x0F; }
+        else e.type = Type::Reply;
+        break;
+    case 0x60:
+        e.type = Type::Error;
+        if (n >= 4) e.arg = b[2];
+        break;
+    }
+}
+
+// "yyyy-MM-dd HH:mm:ss.zzz TX 81 01 ... FF", "... RX ..." or "... <event>".
+// Lines without a time stamp (the writer's drop notices) count as events
+// at the previous line's time.
+void CaptureIndex::addLine(const char *line, qsizetype len)
+{
+    Entry e{};
+    e.arg = NO_ARG;
+    const char *body = line;
+    qsizetype bodyLen = len;
+
+    const bool stamped = len >= 24 && line[4] == '-' && line[10] == ' ' && line[13] == ':'
+                         && line[19] == '.' && line[23] == ' ';
+    if (stamped) {
+        // The hour is cached with its date so DST changes land correctly
+        const QByteArray hour = QByteArray::fromRawData(line, 13);
+        if (hour != lastDate) {
+            lastDate = QByteArray(line, 13);
+            const QDate d = QDate::fromString(QString::fromLatin1(line, 10), Qt::ISODate);
+            lastDayMs = QDateTime(d, QTime(twoDigits(line + 11), 0)).toMSecsSinceEpoch();
+        }
+        e.ms = lastDayMs + twoDigits(line + 14) * 60'000 + twoDigits(line + 17) * 1000
+               + (line[20] - '0') * 100 + twoDigits(line + 21);
+        body = line + 24;
+        bodyLen = len - 24;
+    } else {
+        e.ms = entries.empty() ? 0 : entries.back().ms;
+    }
+
+    const bool tx = bodyLen > 3 && body[0] == 'T' && body[1] == 'X' && body[2] == ' ';
+    const bool rx = bodyLen > 3 && body[0] == 'R' && body[1] == 'X' && body[2] == ' ';
+    e.pool = quint32(pool.size());
+    if (stamped && (tx || rx)) {
+        e.dir = tx ? Dir::Tx : Dir::Rx;
+        for (qsizetype i = 3; i + 1 < bodyLen; i += 3) {
+            const int hi = hexDigit(body[i]), lo = hexDigit(body[i + 1]);
+            if (hi < 0 || lo < 0) break;
+            pool += char(hi << 4 | lo);
+        }
+        e.len = quint16(pool.size() - e.pool);
+        classify(e, reinterpret_cast<const quint8 *>(pool.constData() + e.pool), e.len);
+    } else {
+        e.dir = Dir::Event;
+        e.type = Type::Event;
+        e.len = quint16(std::min<qsizetype>(bodyLen, 0xFFFF));
+        pool.append(body, e.len);
+    }
+
+    byType[std::size_t(e.type)].push_back(quint32(entries.size()));
+    entries.push_back(e);
+}
+
+// -------------------- Queries --------------------
+
+static bool parseTypeTerm(const QString &term, int &type, int &arg, QString *error)
+{
+    const QString name = term.section('=', 0, 0).toLower();
+    const QString value = term.section('=', 1);
+    const auto *it = std::find_if(std::begin(TYPE_NAMES), std::end(TYPE_NAMES),
+                                  [&](const char *n) { return name == QLatin1String(n); });
+    if (it == std::end(TYPE_NAMES) || name == "event") {
+        if (error) *error = QString("unknown term \"%1\"").arg(term);
+        return false;
+    }
+    type = int(it - std::begin(TYPE_NAMES));
+    arg = -1;
+    if (value.isEmpty()) return true;
+
+    bool ok = false;
+    if (CaptureIndex::Type(type) == CaptureIndex::Type::Error) {
+        for (const ErrorName &n : ERROR_NAMES)
+            if (value.compare(QLatin1String(n.name), Qt::CaseInsensitive) == 0) { arg = n.code; ok = true; }
+        if (!ok) arg = value.toInt(&ok, 16);
+    } else {
+        arg = value.toInt(&ok);
+    }
+    if (!ok || arg < 0 || arg > 0xFE) {
+        if (error) *error = QString("bad value in \"%1\"").arg(term);
+        return false;
+    }
+    return true;
+}
+
+bool CaptureIndex::parse(const QString &text, Query &q, QString *error) const
+{
+    q = Query{};
+    auto fail = [&](const QString &msg) { if (error) *error = msg; return false; };
+    auto parseTime = [&](const QString &s, qint64 &ms) {
+        QDateTime dt = QDateTime::fromString(s, Qt::ISODate);
+        if (!dt.isValid()) {
+            QTime t = QTime::fromString(s, "H:mm:ss");
+            if (!t.isValid()) t = QTime::fromString(s, "H:mm");
+            if (!t.isValid()) return false;
+            const QDate day = entries.empty() ? QDate::currentDate()
+                                              : QDateTime::fromMSecsSinceEpoch(entries.front().ms).date();
+            dt = QDateTime(day, t);
+        }
+        ms = dt.toMSecsSinceEpoch();
+        return true;
+    };
+
+    const QStringList terms = text.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    for (const QString &t : terms) {
+        const QString key = t.section(':', 0, 0).toLower();
+        const QString value = t.section(':', 1);
+        bool ok = true;
+        if (t == "tx" || t == "rx" || t == "event") {
+            q.dir = int(t == "tx" ? Dir::Tx : t == "rx" ? Dir::Rx : Dir::Event);
+        } else if (!t.contains(':')) {
+            if (q.type >= 0) return fail("only one frame type per query");
+            if (!parseTypeTerm(t, q.type, q.arg, error)) return false;
+        } else if (key == "cam") {
+            q.address = value.toInt(&ok);
+            if (!ok || q.address < 0 || q.address > 8) return fail("cam: takes 1..8");
+        } else if (key == "bytes") {
+            q.nibbles = value.toUpper().toLatin1();
+            for (char c : std::as_const(q.nibbles))
+                if (c != '?' && hexDigit(c) < 0) return fail("bytes: takes hex digits and ?");
+        } else if (key == "text") {
+            q.text = value;
+        } else if (key == "after") {
+            if (!parseTypeTerm(value, q.afterType, q.afterArg, error)) return false;
+        } else if (key == "within") {
+            q.withinMs = qint64(value.toDouble(&ok) * 1000);
+            if (!ok || q.withinMs < 0) return fail("within: takes seconds");
+        } else if (key == "from" || key == "to") {
+            if (!parseTime(value, key == "from" ? q.fromMs : q.toMs))
+                return fail(QString("cannot read the time in \"%1\"").arg(t));
+        } else {
+            return fail(QString("unknown term \"%1\"").arg(t));
+        }
+    }
+    if (q.withinMs >= 0 && q.afterType < 0) return fail("within: needs after:");
+    return true;
+}
+
+bool CaptureIndex::matches(const Entry &e, const Query &q) const
+{
+    if (q.dir >= 0 && int(e.dir) != q.dir) return false;
+    if (q.address >= 0 && e.address != q.address) return false;
+    if (q.arg >= 0 && e.arg != q.arg) return false;
+    const char *data = pool.constData() + e.pool;
+    if (!q.nibbles.isEmpty()) {
+        if (e.dir == Dir::Event || e.len * 2 < q.nibbles.size()) return false;
+        for (qsizetype i = 0; i < q.nibbles.size(); ++i) {
+            if (q.nibbles[i] == '?') continue;
+            const quint8 b = quint8(data[i / 2]);
+            if (((i % 2) ? (b & 0x0F) : (b >> 4)) != hexDigit(q.nibbles[i])) return false;
+        }
+    }
+    if (!q.text.isEmpty()) {
+        if (e.dir != Dir::Event) return false;
+        if (!QString::fromUtf8(data, e.len).contains(q.text, Qt::CaseInsensitive)) return false;
+    }
+    return true;
+}
+
+std::vector<quint32> CaptureIndex::find(const Query &q, std::size_t limit, std::size_t *total) const
+{
+    // Walk a posting list when the query names a type; all entries otherwise
+    const std::vector<quint32> *list = nullptr;
+    if (q.type >= 0) list = &byType[std::size_t(q.type)];
+    else if (q.dir == int(Dir::Event)) list = &byType[std::size_t(Type::Event)];
+    const std::size_t n = list ? list->size() : entries.size();
+    auto at = [&](std::size_t k) { return list ? (*list)[k] : quint32(k); };
+
+    // Log times only move forward, so both lists are sorted by time too
+    auto firstWhere = [&](auto pred) {
+        std::size_t lo = 0, hi = n;
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (pred(entries[at(mid)].ms)) hi = mid; else lo = mid + 1;
+        }
+        return lo;
+    };
+    const std::size_t from = q.fromMs >= 0 ? firstWhere([&](qint64 ms) { return ms >= q.fromMs; }) : 0;
+    const std::size_t to = q.toMs >= 0 ? firstWhere([&](qint64 ms) { return ms > q.toMs; }) : n;
+
+    // Latest `after` frame per camera; slot 0 is "any camera" for events
+    const std::vector<quint32> *afterList = q.afterType >= 0 ? &byType[std::size_t(q.afterType)] : nullptr;
+    std::size_t j = 0;
+    std::array<int, 9> lastArg;
+    std::array<qint64, 9> lastMs;
+    lastArg.fill(-1);
+    lastMs.fill(-1);
+
+    std::vector<quint32> out;
+    std::size_t count = 0;
+    for (std::size_t k = from; k < to; ++k) {
+        const quint32 i = at(k);
+        const Entry &e = entries[i];
+        if (afterList) {
+            for (; j < afterList->size() && (*afterList)[j] < i; ++j) {
+                const Entry &a = entries[(*afterList)[j]];
+                const std::size_t slot = std::min<std::size_t>(a.address, 8);
+                lastArg[slot] = lastArg[0] = a.arg;
+                lastMs[slot] = lastMs[0] = a.ms;
+            }
+            const std::size_t slot = std::min<std::size_t>(e.address, 8);
+            if (lastMs[slot] < 0) continue;
+            if (q.afterArg >= 0 && lastArg[slot] != q.afterArg) continue;
+            if (q.withinMs >= 0 && e.ms - lastMs[slot] > q.withinMs) continue;
+        }
+        if (!matches(e, q)) continue;
+        if (out.size() < limit) out.push_back(i);
+        ++count;
+    }
+    if (total) *total = count;
+    return out;
+}
+
+QString CaptureIndex::format(quint32 i) const
+{
+    const Entry &e = entries[i];
+    const char *data = pool.constData() + e.pool;
+    QString s = QDateTime::fromMSecsSinceEpoch(e.ms).toString("yyyy-MM-dd HH:mm:ss.zzz ");
+    if (e.dir == Dir::Event) return s + QString::fromUtf8(data, e.len);
+
+    s += e.dir == Dir::Tx ? "TX " : "RX ";
+    s += QString::fromLatin1(QByteArray::fromRawData(data, e.len).toHex(' ').toUpper());
+    if (e.type == Type::Other) return s;
+    s += QString("    // %1").arg(typeName(e.type));
+    if (e.type == Type::Error) {
+        const auto *n = std::find_if(std::begin(ERROR_NAMES), std::end(ERROR_NAMES),
+                                     [&](const ErrorName &x) { return x.code == e.arg; });
+        s += n != std::end(ERROR_NAMES) ? QString(" %1").arg(n->name)
+                                        : QString(" %1").arg(e.arg, 2, 16, QLatin1Char('0'));
+    } else if (e.arg != NO_ARG) {
+        s += QString(" %1").arg(e.arg);
+    }
+    if (e.address) s += QString(", cam %1").arg(e.address);
+    return s;
+}
@@ -0,0 +1,100 @@
+#ifndef CAPTUREINDEX_H
+#define CAPTUREINDEX_H
+
+// Searchable index over recorded session logs (see sessionlog.h).
+//
+// Loading parses every line once into a fixed-size Entry (time, direction,
+// camera address, frame type, one argument such as the preset number or
+// error code) plus the raw frame bytes in one shared pool, and keeps a
+// posting list of entry numbers per frame type. A query that names a frame
+// type (or asks for events) walks only that type's posting list, otherwise
+// every entry; it narrows by time with a binary search and checks the rest
+// per entry, so typical filters over millions of frames take milliseconds.
+// after: terms are followed alongside in their own type's list.
+//
+// Query terms, all of which must hold:
+//   tx | rx | event                direction
+//   cam:N                          camera address (8 = broadcast)
+//   recall[=N] store[=N] ptz zoom focus power inquiry cancel clear
+//   ack done reply error[=KIND]    frame type; KIND is a hex code or a name
+//                                  like buffer_full; only one type per query
+//   bytes:906?                     frame starts with these nibbles, ? = any
+//   text:WORD                      event line contains WORD
+//   after:TYPE[=N]                 the latest TYPE frame for the same camera
+//                                  before this one had argument N
+//   within:SECONDS                 ... and was at most this long before
+//   from:T to:T                    ISO date-time, or HH:mm[:ss] on the
+//                                  capture's first day
+// e.g. "error after:recall=5" finds errors following a recall of preset 5.
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class CaptureIndex
+{
+public:
+    enum class Dir : quint8 { Tx, Rx, Event };
+    enum class Type : quint8 {
+        Other, Recall, Store, PanTilt, Zoom, Focus, Power, Inquiry, Cancel, IfClear,
+        Ack, Completion, Reply, Error, AddressSet, Event,
+        Count
+    };
+
+    struct Entry {
+        qint64  ms;         // wall clock, ms since epoch
+        quint32 pool;       // offset of the frame bytes / event text
+        quint16 len;
+        Dir     dir;
+        quint8  address;    // 1..7, 8 = broadcast, 0 = none (events)
+        Type    type;
+        quint8  arg;        // preset, error code or socket; 0xFF = none
+    };
+
+    struct Query {
+        int        dir = -1;                  // Dir, -1 = any
+        int        address = -1;
+        int        type = -1;                 // Type, -1 = any
+        int        arg = -1;
+        QByteArray nibbles;                   // hex digits, '?' = any
+        QString    text;
+        int        afterType = -1;
+        int        afterArg = -1;
+        qint64     withinMs = -1;
+        qint64     fromMs = -1, toMs = -1;
+    };
+
+    // Appends the files in order; rotated .gz files are inflated in-process.
+    // Touches nothing but this index, so it may run on a worker thread.
+    bool load(const QStringList &files, QString *error = nullptr);
+    void clear();
+
+    std::size_t size() const { return entries.size(); }
+    std::size_t frames() const { return entries.size() - byType[std::size_t(Type::Event)].size(); }
+
+    bool parse(const QString &text, Query &q, QString *error) const;
+    // Entry numbers in order, at most `limit`; `total` gets the full count.
+    std::vector<quint32> find(const Query &q, std::size_t limit, std::size_t *total = nullptr) const;
+    QString format(quint32 entry) const;
+
+    static const char *typeName(Type t);
+
+private:
+    void addLine(const char *line, qsizetype len);
+    bool matches(const Entry &e, const Query &q) const;
+
+    std::vector<Entry> entries;
+    QByteArray pool;
+    std::array<std::vector<quint32>, std::size_t(Type::Count)> byType;
+
+    // Date part of the last parsed line, to avoid a QDateTime per line
+    QByteArray lastDate;
+    qint64     lastDayMs = 0;
+};
+
+#endif // CAPTUREINDEX_H
@@ -0,0 +1,130 @@
+#include "capturesearch.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentRun>
+
+CaptureSearchDialog::CaptureSearchDialog(const QString &dir, QWidget *parent)
+    : QDialog(parent), logDir(dir)
+{
+    setWindowTitle("Search Session Log");
+    resize(720, 480);
+
+    auto *rootV = new QVBoxLayout(this);
+
+    auto *fileRow = new QHBoxLayout();
+    filesLabel = new QLabel("No log loaded", this);
+    filesLabel->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Preferred);
+    auto *openBtn = new QPushButton("Open…", this);
+    fileRow->addWidget(filesLabel, 1);
+    fileRow->addWidget(openBtn);
+    rootV->addLayout(fileRow);
+
+    queryEdit = new QLineEdit(this);
+    queryEdit->setPlaceholderText("e.g.  error after:recall=5    rx cam:1 bytes:906?    from:14:00 to:14:30");
+    queryEdit->setToolTip("tx rx event · cam:N · recall[=N] store[=N] ptz zoom focus power inquiry "
+                          "cancel clear ack done reply error[=kind] · bytes:906? · text:WORD · "
+                          "after:TYPE[=N] within:SEC · from:T to:T");
+    rootV->addWidget(queryEdit);
+
+    results = new QPlainTextEdit(this);
+    results->setReadOnly(true);
+    results->setLineWrapMode(QPlainTextEdit::NoWrap);
+    {
+        QFont mono = results->font();
+        mono.setStyleHint(QFont::Monospace);
+        mono.setFamily("monospace");
+        results->setFont(mono);
+    }
+    rootV->addWidget(results, 1);
+
+    statusLabel = new QLabel(this);
+    rootV->addWidget(statusLabel);
+
+    connect(openBtn, &QPushButton::clicked, this, &CaptureSearchDialog::chooseFiles);
+    connect(queryEdit, &QLineEdit::returnPressed, this, &CaptureSearchDialog::search);
+    connect(&loader, &QFutureWatcher<Loaded>::finished, this, &CaptureSearchDialog::indexLoaded);
+
+    // Default to the log being written right now
+    const QFileInfoList logs = QDir(logDir).entryInfoList({"simpleptz-*.log"}, QDir::Files, QDir::Name);
+    if (!logs.isEmpty()) openFiles({logs.last().absoluteFilePath()});
+}
+
+void CaptureSearchDialog::chooseFiles()
+{
+    const QStringList files = QFileDialog::getOpenFileNames(
+        this, "Open Session Logs", logDir, "Session logs (simpleptz-*.log simpleptz-*.log.gz);;All files (*)");
+    if (!files.isEmpty()) openFiles(files);
+}
+
+void CaptureSearchDialog::openFiles(const QStringList &files)
+{
+    QStringList sorted = files;
+    sorted.sort();   // names carry the start time, so this is session order
+
+    QStringList names;
+    for (const QString &f : std::as_const(sorted)) names << QFileInfo(f).fileName();
+    filesLabel->setText(names.join(", "));
+    filesLabel->setToolTip(sorted.join('\n'));
+    statusLabel->setText("Indexing…");
+    results->clear();
+    index.clear();
+    queryEdit->setEnabled(false);
+
+    loader.setFuture(QtConcurrent::run([sorted] {
+        Loaded r;
+        QElapsedTimer t;
+        t.start();
+        r.ok = r.index.load(sorted, &r.error);
+        r.ms = t.elapsed();
+        return r;
+    }));
+}
+
+void CaptureSearchDialog::indexLoaded()
+{
+    Loaded r = loader.future().takeResult();
+    index = std::move(r.index);
+    queryEdit->setEnabled(true);
+    queryEdit->setFocus();
+    statusLabel->setText(r.ok ? QString("%1 frames, %2 events indexed in %3 ms")
+                                    .arg(index.frames()).arg(index.size() - index.frames()).arg(r.ms)
+                              : r.error);
+    if (r.ok && !queryEdit->text().trimmed().isEmpty()) search();
+}
+
+void CaptureSearchDialog::search()
+{
+    CaptureIndex::Query q;
+    QString error;
+    if (!index.parse(queryEdit->text(), q, &error)) {
+        statusLabel->setText(error);
+        return;
+    }
+
+    QElapsedTimer t;
+    t.start();
+    std::size_t total = 0;
+    const std::vector<quint32> hits = index.find(q, MAX_SHOWN, &total);
+    const qint64 queryMs = t.elapsed();
+
+    QString text;
+    text.reserve(qsizetype(hits.size()) * 64);
+    for (quint32 i : hits) {
+        text += index.format(i);
+        text += '\n';
+    }
+    results->setPlainText(text);
+    statusLabel->setText(QString("%1 of %2 entries match in %3 ms%4")
+                             .arg(total).arg(index.size()).arg(queryMs)
+                             .arg(total > hits.size() ? QString(", first %1 shown").arg(hits.size())
+                                                      : QString()));
+}
@@ -0,0 +1,51 @@
+#ifndef CAPTURESEARCH_H
+#define CAPTURESEARCH_H
+
+// Search window over session logs (Ctrl+F). Opens the newest log in the
+// session log directory, or the files picked with "Open…", and runs
+// CaptureIndex queries against it; see captureindex.h for the syntax.
+// Files are read and indexed on a worker thread, so a multi-hour capture
+// doesn't freeze the UI.
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include "captureindex.h"
+
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+
+class CaptureSearchDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    static const int MAX_SHOWN = 10000;   // more would only slow the view down
+
+    explicit CaptureSearchDialog(const QString &logDir, QWidget *parent = nullptr);
+
+    void openFiles(const QStringList &files);
+
+private:
+    struct Loaded
+    {
+        CaptureIndex index;
+        bool         ok = false;
+        QString      error;
+        qint64       ms = 0;
+    };
+
+    void chooseFiles();
+    void indexLoaded();
+    void search();
+
+    QString logDir;
+    CaptureIndex index;
+    QFutureWatcher<Loaded> loader;    // a newer openFiles() discards an older result
+    QLabel *filesLabel{};
+    QLineEdit *queryEdit{};
+    QPlainTextEdit *results{};
+    QLabel *statusLabel{};
+};
+
+#endif // CAPTURESEARCH_H
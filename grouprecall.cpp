@@ -0,0 +1,399 @@
+#include "grouprecall.h"
+
+#include <QSerialPort>
+#include <algorithm>
+#include <chrono>
+
+static const int GROUP_TIMEOUT_MS = 10000;
+
+// The engine's write times are steady_clock, so the flushes done here are too
+static qint64 steadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GroupRecall::GroupRecall(SharedPort shared, QObject *parent)
+    : QObject(parent), shared(std::move(shared))
+{
+    timeout.setSingleShot(true);
+    connect(&timeout, &QTimer::timeout, this, &GroupRecall::onTimeout);
+}
+
+GroupRecall::~GroupRecall()
+{
+    closePorts();
+}
+
+QList<GroupMember> GroupRecall::parseMembers(const QStringList &spec)
+{
+    QList<GroupMember> out;
+    for (const QString &raw : spec) {
+        QString s = raw.trimmed();
+        if (s.isEmpty()) continue;
+        GroupMember m;
+        const int at = s.lastIndexOf('@');
+        if (at > 0) {
+            bool ok = false;
+            m.baud = s.mid(at + 1).trimmed().toInt(&ok);
+            if (!ok || m.baud <= 0) continue;
+            s = s.left(at).trimmed();
+        }
+        // Split on the last ':' so Windows "COM4:2" and "/dev/ttyUSB0:2" both work
+        const int colon = s.lastIndexOf(':');
+        if (colon > 0) {
+            m.port = s.left(colon).trimmed();
+            const QString a = s.mid(colon + 1).trimmed();
+            if (a == "*") {
+                m.address = 0;
+            } else {
+                bool ok = false;
+                m.address = a.toInt(&ok);
+                if (!ok || m.address < 1 || m.address > 7) continue;
+            }
+        } else {
+            m.port = s;
+        }
+        out << m;
+    }
+    return out;
+}
+
+QStringList GroupRecall::formatMembers(const QList<GroupMember> &members)
+{
+    QStringList out;
+    for (const GroupMember &m : members)
+        out << m.port + ":" + (m.address == 0 ? QString("*") : QString::number(m.address))
+                   + (m.baud ? "@" + QString::number(m.baud) : QString());
+    return out;
+}
+
+GroupRecall::OwnPort GroupRecall::portFor(const QString &name, int baud, QString *error)
+{
+    auto it = ownPorts.find(name);
+    if (it != ownPorts.end()) {
+        if (it->serial && it->baud != baud) it->serial->setBaudRate(baud);
+        it->baud = baud;
+        return *it;
+    }
+
+    OwnPort own;
+    own.baud = baud;
+    if (LinkEngine::supported()) {
+        if (!engine) {
+            // Handlers run on the reactor thread; hand everything to ours
+            const int epoch = engineEpoch;
+            LinkEngine::Handlers h;
+            h.frame = [this, epoch](LinkEngine::LinkId id, const visca::Byte *f, std::size_t n) {
+                const QByteArray frame(reinterpret_cast<const char *>(f), qsizetype(n));
+                QMetaObject::invokeMethod(this, [this, epoch, id, frame] {
+                    if (epoch != engineEpoch) return;
+                    const auto *b = reinterpret_cast<const visca::Byte *>(frame.constData());
+                    onReply(portOf(id), visca::decode(b, std::size_t(frame.size()), visca::Inquiry::None));
+                }, Qt::QueuedConnection);
+            };
+            h.written = [this, epoch](LinkEngine::LinkId id, std::int64_t ns) {
+                QMetaObject::invokeMethod(this, [this, epoch, id, ns] {
+                    if (epoch == engineEpoch) onWritten(portOf(id), ns);
+                }, Qt::QueuedConnection);
+            };
+            h.closed = [this, epoch](LinkEngine::LinkId id, const std::string &reason) {
+                const QString why = QString::fromStdString(reason);
+                QMetaObject::invokeMethod(this, [this, epoch, id, why] {
+                    if (epoch == engineEpoch) dropPort(portOf(id), why);
+                }, Qt::QueuedConnection);
+            };
+            engine = std::make_unique<LinkEngine>(std::move(h), 1);
+        }
+        // The engine wants a device path; QSerialPort takes a bare name too
+        const QString path = name.contains('/') ? name : "/dev/" + name;
+        std::string err;
+        own.link = engine->openSerial(path.toStdString(), baud, &err);
+        if (own.link < 0) {
+            *error = QString("%1: %2").arg(name, QString::fromStdString(err));
+            return {};
+        }
+        ownPorts.insert(name, own);
+        return own;
+    }
+
+    auto *p = new QSerialPort(this);
+    p->setPortName(name);
+    p->setBaudRate(baud);
+    if (!p->open(QIODevice::ReadWrite)) {
+        *error = QString("%1: %2").arg(name, p->errorString());
+        delete p;
+        return {};
+    }
+    own.serial = p;
+    ownPorts.insert(name, own);
+    connect(p, &QSerialPort::readyRead, this, [this, p]{ readOwnPort(p); });
+    connect(p, &QSerialPort::errorOccurred, this, [this, p](QSerialPort::SerialPortError err) {
+        if (err == QSerialPort::NoError) return;
+        QString name;
+        for (auto it = ownPorts.cbegin(); it != ownPorts.cend(); ++it)
+            if (it->serial == p) name = it.key();
+        dropPort(name, p->errorString());
+    });
+    return own;
+}
+
+QString GroupRecall::portOf(LinkEngine::LinkId link) const
+{
+    for (auto it = ownPorts.cbegin(); it != ownPorts.cend(); ++it)
+        if (it->link == link) return it.key();
+    return {};
+}
+
+void GroupRecall::closePort(const QString &name)
+{
+    const OwnPort own = ownPorts.take(name);
+    if (own.serial) {
+        ownRx.remove(own.serial);
+        own.serial->close();
+        own.serial->deleteLater();
+    } else if (own.link >= 0 && engine) {
+        engine->close(own.link);    // its closed handler no longer finds a name
+    }
+}
+
+void GroupRecall::dropPort(const QString &name, const QString &why)
+{
+    const OwnPort own = ownPorts.value(name);
+    if (!own.isOpen()) return;
+    emit report(QString("Group port %1 error: %2").arg(name, why));
+    unwritten.remove(name);   // what it didn't write never will be
+    // An engine link has already shut and freed itself
+    if (own.link >= 0) ownPorts.remove(name);
+    else closePort(name);
+    if (active && settled()) finish(false);
+}
+
+void GroupRecall::closePorts()
+{
+    for (const OwnPort &own : std::as_const(ownPorts)) {
+        if (!own.serial) continue;
+        own.serial->close();
+        own.serial->deleteLater();
+    }
+    ownPorts.clear();
+    ownRx.clear();
+    // Joins the reactor and closes every link now, so the ports are free
+    // for the next connect; anything it already queued here is ignored
+    engine.reset();
+    ++engineEpoch;
+}
+
+bool GroupRecall::recall(const QString &group, const QList<GroupMember> &members, int preset, int defaultBaud)
+{
+    if (active) {
+        emit report(QString("Group '%1': previous recall still running").arg(groupName));
+        return false;
+    }
+    if (members.isEmpty()) {
+        emit report(QString("Group '%1' has no members").arg(group));
+        return false;
+    }
+
+    // An engine link can't change baud; reopen the ports afresh instead
+    if (engine) {
+        QHash<QString, int> bauds;
+        for (const GroupMember &m : members)
+            if (!bauds.contains(m.port)) bauds.insert(m.port, m.baud ? m.baud : defaultBaud);
+        const bool stale = std::any_of(bauds.keyValueBegin(), bauds.keyValueEnd(), [&](const auto &kv) {
+            const OwnPort own = ownPorts.value(kv.first);
+            return own.link >= 0 && own.baud != kv.second;
+        });
+        if (stale) closePorts();
+    }
+
+    // Build every frame and open every port before anything is written.
+    // A batch without an own port is for the shared connection.
+    struct PortBatch { OwnPort port; QList<visca::RawFrame> frames; };
+    QList<QString> order;
+    QHash<QString, PortBatch> batches;
+    QList<Pending> expect;
+    QList<QString> opened;   // by this recall, closed again if another fails
+    for (const GroupMember &m : members) {
+        if (!batches.contains(m.port)) {
+            QString err;
+            OwnPort p;
+            const bool sharedPort = shared.owns && shared.owns(m.port);
+            const bool known = ownPorts.contains(m.port);
+            if (!sharedPort && !(p = portFor(m.port, m.baud ? m.baud : defaultBaud, &err)).isOpen()) {
+                emit report(QString("Group '%1' not recalled, cannot open %2").arg(group, err));
+                for (const QString &name : std::as_const(opened)) closePort(name);
+                return false;
+            }
+            if (!sharedPort && !known) opened << m.port;
+            batches.insert(m.port, PortBatch{p, {}});
+            order << m.port;
+        }
+    }
+    for (const QString &port : std::as_const(order)) {
+        PortBatch &b = batches[port];
+        const bool broadcast = std::any_of(members.begin(), members.end(), [&](const GroupMember &m) {
+            return m.port == port && m.address == 0;
+        });
+        if (broadcast) {
+            b.frames << visca::PresetRecall::encode(visca::BROADCAST, preset);
+            ++broadcasts;
+            continue;
+        }
+        for (const GroupMember &m : members) {
+            if (m.port != port) continue;
+            b.frames << visca::PresetRecall::encode(m.address, preset);
+            expect << Pending{port, m.address};
+        }
+    }
+
+    groupName = group;
+    pending = expect;
+    active = true;
+    clock.start();
+
+    // Queue on every own QSerialPort first, then push the bytes out back to
+    // back; sendVisca writes and flushes the shared port in one go and the
+    // engine's reactor writes a link's frames as soon as they are handed over.
+    for (const QString &port : std::as_const(order)) {
+        const PortBatch &b = batches[port];
+        if (!b.port.serial) continue;
+        for (const visca::RawFrame &f : b.frames)
+            b.port.serial->write(f.data(), qsizetype(f.size));
+    }
+    // An engine port's start is when its reactor reports the last frame
+    // written, which arrives here queued; see onWritten()
+    firstStartNs = lastStartNs = -1;
+    unwritten.clear();
+    for (const QString &port : std::as_const(order)) {
+        const PortBatch &b = batches[port];
+        if (b.port.link >= 0) {
+            int queued = 0;
+            for (const visca::RawFrame &f : b.frames) {
+                if (engine->send(b.port.link, f.bytes.data(), f.size)) ++queued;
+                else emit report(QString("Group port %1: frame dropped, link closed or busy").arg(port));
+            }
+            if (queued) unwritten.insert(port, queued);
+            continue;
+        }
+        if (b.port.serial) {
+            b.port.serial->flush();
+        } else {
+            for (const visca::RawFrame &f : b.frames) shared.send(f);
+        }
+        markStart(steadyNs());
+    }
+
+    emit report(QString("Group '%1': recall preset %2 sent to %3 port(s), %4 addressed, %5 broadcast")
+                    .arg(group).arg(preset).arg(order.size()).arg(pending.size()).arg(broadcasts));
+
+    if (settled()) finish(false);
+    else timeout.start(GROUP_TIMEOUT_MS);
+    return true;
+}
+
+void GroupRecall::onWritten(const QString &port, qint64 steadyNs)
+{
+    if (!active) return;
+    auto it = unwritten.find(port);
+    if (it == unwritten.end() || --*it > 0) return;
+    unwritten.erase(it);
+    markStart(steadyNs);
+    if (settled()) finish(false);
+}
+
+void GroupRecall::markStart(qint64 steadyNs)
+{
+    firstStartNs = firstStartNs < 0 ? steadyNs : std::min(firstStartNs, steadyNs);
+    lastStartNs = std::max(lastStartNs, steadyNs);
+}
+
+bool GroupRecall::settled() const
+{
+    return unwritten.isEmpty()
+           && std::all_of(pending.cbegin(), pending.cend(), [](const Pending &p) { return p.doneNs >= 0; });
+}
+
+void GroupRecall::readOwnPort(QSerialPort *port)
+{
+    QByteArray &buf = ownRx[port];
+    buf += port->readAll();
+    QString name;
+    for (auto it = ownPorts.cbegin(); it != ownPorts.cend(); ++it)
+        if (it->serial == port) name = it.key();
+    qsizetype start = 0;
+    while (true) {
+        const qsizetype end = buf.indexOf(char(0xFF), start);
+        if (end < 0) break;
+        const auto *frame = reinterpret_cast<const visca::Byte *>(buf.constData() + start);
+        onReply(name, visca::decode(frame, std::size_t(end - start + 1), visca::Inquiry::None));
+        start = end + 1;
+    }
+    if (start > 0) buf.remove(0, start);
+}
+
+void GroupRecall::onReply(const QString &port, const visca::Reply &r)
+{
+    if (!active) return;
+    // A camera acknowledges frames in the order they arrived
+    if (r.kind == visca::ReplyKind::Ack) {
+        for (Pending &p : pending) {
+            if (p.socket < 0 && p.doneNs < 0 && p.port == port && p.address == r.address) {
+                p.socket = r.socket;
+                break;
+            }
+        }
+        return;
+    }
+    if (r.kind != visca::ReplyKind::Completion && r.kind != visca::ReplyKind::Error) return;
+
+    // A socket-0 error refuses a frame that never got a socket
+    const int socket = r.kind == visca::ReplyKind::Error && r.socket == 0 ? -1 : r.socket;
+    for (Pending &p : pending) {
+        if (p.doneNs < 0 && p.port == port && p.address == r.address && p.socket == socket) {
+            p.doneNs = clock.nsecsElapsed();
+            p.failed = r.kind == visca::ReplyKind::Error;
+            break;
+        }
+    }
+    if (settled()) finish(false);
+}
+
+void GroupRecall::onTimeout()
+{
+    if (active) finish(true);
+}
+
+void GroupRecall::finish(bool timedOut)
+{
+    timeout.stop();
+    active = false;
+
+    const double startSkewMs = firstStartNs < 0 ? 0.0 : double(lastStartNs - firstStartNs) / 1e6;
+    qint64 firstDone = -1, lastDone = -1;
+    int completed = 0, failed = 0;
+    for (const Pending &p : std::as_const(pending)) {
+        if (p.doneNs < 0) continue;
+        if (p.failed) { ++failed; continue; }
+        ++completed;
+        if (firstDone < 0 || p.doneNs < firstDone) firstDone = p.doneNs;
+        lastDone = std::max(lastDone, p.doneNs);
+    }
+
+    QString line = QString("Group '%1': start skew %2 ms").arg(groupName).arg(startSkewMs, 0, 'f', 2);
+    if (completed > 0)
+        line += QString(", completion skew %1 ms (%2/%3 done)")
+                    .arg(double(lastDone - firstDone) / 1e6, 0, 'f', 1)
+                    .arg(completed).arg(pending.size());
+    else if (!pending.isEmpty())
+        line += QString(", no completions (0/%1)").arg(pending.size());
+    if (failed) line += QString(", %1 error(s)").arg(failed);
+    if (timedOut) line += ", timed out";
+    if (broadcasts) line += QString(", %1 broadcast port(s) unmeasured").arg(broadcasts);
+    if (!unwritten.isEmpty()) line += QString(", %1 port(s) never confirmed written").arg(unwritten.size());
+    emit report(line);
+
+    pending.clear();
+    unwritten.clear();
+    broadcasts = 0;
+}
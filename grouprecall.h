@@ -0,0 +1,130 @@
+#ifndef GROUPRECALL_H
+#define GROUPRECALL_H
+
+// Synchronized preset recall across a group of cameras.
+//
+// Members live on one or more serial ports. A member with address 0 ("*")
+// stands for every camera on that port and is reached with one VISCA
+// broadcast frame (88 ...); other members get one addressed frame each.
+// All frames are encoded before the first byte goes out, queued on every
+// port, then flushed back to back so the start skew is bounded by the
+// flush loop rather than by frame construction or the event loop.
+//
+// Start skew is measured from the first to the last port whose frames have
+// left: after a QSerialPort flush, or when the engine's reactor reports the
+// last frame written (not when it was queued for the reactor). Completion
+// skew runs from the first to the last 9y 5z FF of the addressed members
+// (cameras do not reply to broadcasts). Each member's completion is matched
+// on the socket its ACK named, so replies to other commands on a shared
+// port don't count.
+//
+// Ports other than the caller's own connection run on a one-reactor
+// LinkEngine where it is supported, so their writes and reads stay off the
+// GUI thread; replies come back to it queued. Elsewhere they are
+// QSerialPorts.
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+
+#include "linkengine.h"
+#include "viscareply.h"
+
+class QSerialPort;
+
+struct GroupMember
+{
+    QString port;
+    int     address = 1;    // 1..7, 0 = all cameras on the port (broadcast)
+    int     baud = 0;       // 0 = the profile's
+};
+
+class GroupRecall : public QObject
+{
+    Q_OBJECT
+public:
+    // The caller's own connection. Frames for it go through `send`
+    // (MainWindow::sendVisca) so they are logged and tracked like any other
+    // command; every other port GroupRecall opens and keeps itself.
+    struct SharedPort
+    {
+        std::function<bool(const QString &port)>     owns;
+        std::function<void(const visca::RawFrame &)> send;
+    };
+
+    explicit GroupRecall(SharedPort shared, QObject *parent = nullptr);
+    ~GroupRecall() override;
+
+    // "COM4:2", "/dev/ttyUSB0:*", "COM5:1@38400"; a missing address means
+    // camera 1, a missing baud the profile's.
+    static QList<GroupMember> parseMembers(const QStringList &spec);
+    static QStringList formatMembers(const QList<GroupMember> &members);
+
+    // Ports GroupRecall opens itself run at the first member's baud on that
+    // port, or `defaultBaud`.
+    bool recall(const QString &group, const QList<GroupMember> &members, int preset, int defaultBaud);
+    bool isActive() const { return active; }
+
+    // Replies read on the shared port are forwarded here.
+    void onReply(const QString &port, const visca::Reply &r);
+
+    void closePorts();
+
+signals:
+    void report(const QString &line);
+
+private slots:
+    void onTimeout();
+
+private:
+    struct Pending
+    {
+        QString port;
+        int     address = 1;
+        int     socket = -1;    // from the ACK; -1 until it arrives
+        qint64  doneNs = -1;
+        bool    failed = false;
+    };
+
+    // One of `serial` or `link` is set
+    struct OwnPort
+    {
+        QSerialPort        *serial = nullptr;
+        LinkEngine::LinkId  link = -1;
+        int                 baud = 0;
+        bool isOpen() const { return serial || link >= 0; }
+    };
+
+    OwnPort portFor(const QString &name, int baud, QString *error);
+    QString portOf(LinkEngine::LinkId link) const;
+    void closePort(const QString &name);
+    void dropPort(const QString &name, const QString &why);
+    void readOwnPort(QSerialPort *port);
+    void onWritten(const QString &port, qint64 steadyNs);
+    void markStart(qint64 steadyNs);
+    bool settled() const;
+    void finish(bool timedOut);
+
+    SharedPort shared;
+    QHash<QString, OwnPort> ownPorts;
+    QHash<QSerialPort *, QByteArray> ownRx;
+    std::unique_ptr<LinkEngine> engine;
+    int engineEpoch = 0;    // drops replies queued by an engine since closed
+
+    QElapsedTimer clock;
+    QTimer        timeout;
+    QString       groupName;
+    QList<Pending> pending;
+    QHash<QString, int> unwritten;  // engine frames per port not yet written
+    qint64        firstStartNs = 0; // steady_clock
+    qint64        lastStartNs = 0;
+    int           broadcasts = 0;
+    bool          active = false;
+};
+
+#endif // GROUPRECALL_H
@@ -0,0 +1,310 @@
+#include "gzip.h"
+
+#include <QFile>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace gzip {
+
+static constexpr std::array<std::uint32_t, 256> CRC_TABLE = [] {
+    std::array<std::uint32_t, 256> t{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        t[i] = c;
+    }
+    return t;
+}();
+
+static std::uint32_t crc32(const char *data, qsizetype size)
+{
+    std::uint32_t c = 0xFFFFFFFFu;
+    for (qsizetype i = 0; i < size; ++i) c = CRC_TABLE[(c ^ quint8(data[i])) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+static void appendLe32(QByteArray &out, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out += char((v >> (8 * i)) & 0xFF);
+}
+
+QByteArray compress(const QByteArray &data)
+{
+    // qCompress: 4-byte size, 2-byte zlib header, deflate, 4-byte Adler-32
+    const QByteArray z = qCompress(data, 6);
+    if (z.size() < 10) return {};
+
+    QByteArray out;
+    out.reserve(z.size() + 12);
+    // Magic, deflate, no flags, no mtime, default level, unknown OS
+    out.append("\x1F\x8B\x08\x00\x00\x00\x00\x00\x00\xFF", 10);
+    out.append(z.constData() + 6, z.size() - 10);
+    appendLe32(out, crc32(data.constData(), data.size()));
+    appendLe32(out, std::uint32_t(data.size()));
+    return out;
+}
+
+bool compressFile(const QString &path, QString *error)
+{
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly)) {
+        *error = in.errorString();
+        return false;
+    }
+    if (in.size() == 0) {   // nothing worth keeping
+        in.close();
+        return QFile::remove(path);
+    }
+    const QString part = path + ".gz.part";
+    QFile out(part);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *error = out.errorString();
+        return false;
+    }
+    while (!in.atEnd()) {
+        const QByteArray chunk = in.read(CHUNK);
+        const QByteArray member = compress(chunk);
+        if (chunk.isEmpty() || member.isEmpty() || out.write(member) != member.size()) {
+            *error = member.isEmpty() ? QString("deflate failed") : out.errorString();
+            out.close();
+            QFile::remove(part);
+            return false;
+        }
+    }
+    in.close();
+    out.close();
+    QFile::remove(path + ".gz");
+    if (!QFile::rename(part, path + ".gz")) {
+        *error = "cannot rename " + part;
+        QFile::remove(part);
+        return false;
+    }
+    QFile::remove(path);
+    return true;
+}
+
+// -------------------- Inflate --------------------
+
+namespace {
+
+constexpr int MAX_BITS = 15;
+
+struct Bits
+{
+    const quint8 *p;
+    std::size_t   size;
+    std::size_t   pos = 0;
+    std::uint32_t buf = 0;
+    int           count = 0;
+    bool          overrun = false;
+
+    int take(int need)
+    {
+        std::uint32_t v = buf;
+        while (count < need) {
+            if (pos == size) { overrun = true; return 0; }
+            v |= std::uint32_t(p[pos++]) << count;
+            count += 8;
+        }
+        buf = need < 32 ? v >> need : 0;
+        count -= need;
+        return int(v & ((1u << need) - 1));
+    }
+    void alignToByte() { buf = 0; count = 0; }
+};
+
+struct Huffman
+{
+    std::array<short, MAX_BITS + 1> count{};
+    std::array<short, 288> symbol{};
+};
+
+// Canonical code from code lengths: 0 if complete, < 0 over-subscribed,
+// > 0 incomplete
+int build(Huffman &h, const short *length, int n)
+{
+    h.count.fill(0);
+    for (int s = 0; s < n; ++s) ++h.count[std::size_t(length[s])];
+    if (h.count[0] == n) return 0;
+    int left = 1;
+    for (int len = 1; len <= MAX_BITS; ++len) {
+        left = (left << 1) - h.count[std::size_t(len)];
+        if (left < 0) return left;
+    }
+    std::array<short, MAX_BITS + 1> offs{};
+    for (int len = 1; len < MAX_BITS; ++len)
+        offs[std::size_t(len + 1)] = short(offs[std::size_t(len)] + h.count[std::size_t(len)]);
+    for (int s = 0; s < n; ++s)
+        if (length[s]) h.symbol[std::size_t(offs[std::size_t(length[s])]++)] = short(s);
+    return left;
+}
+
+int decode(Bits &b, const Huffman &h)
+{
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len <= MAX_BITS; ++len) {
+        code |= b.take(1);
+        const int count = h.count[std::size_t(len)];
+        if (code - count < first) return h.symbol[std::size_t(index + (code - first))];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+        if (b.overrun) return -1;
+    }
+    return -1;
+}
+
+bool codes(Bits &b, QByteArray &out, qsizetype memberStart, const Huffman &lens, const Huffman &dists)
+{
+    static const short LBASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const short LEXT[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const short DBASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                    8193, 12289, 16385, 24577};
+    static const short DEXT[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                   7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    while (true) {
+        int sym = decode(b, lens);
+        if (sym < 0 || b.overrun) return false;
+        if (sym < 256) {
+            out += char(sym);
+            continue;
+        }
+        if (sym == 256) return true;
+        sym -= 257;
+        if (sym >= 29) return false;
+        const int len = LBASE[sym] + b.take(LEXT[sym]);
+        const int d = decode(b, dists);
+        if (d < 0 || d >= 30) return false;
+        const qsizetype dist = DBASE[d] + b.take(DEXT[d]);
+        if (b.overrun || dist > out.size() - memberStart) return false;
+        // Byte by byte: the source may overlap what is being written
+        for (qsizetype from = out.size() - dist, end = from + len; from < end; ++from) out += out.at(from);
+    }
+}
+
+bool fixedBlock(Bits &b, QByteArray &out, qsizetype memberStart)
+{
+    static const auto tables = [] {
+        std::pair<Huffman, Huffman> t;
+        short l[288];
+        int s = 0;
+        for (; s < 144; ++s) l[s] = 8;
+        for (; s < 256; ++s) l[s] = 9;
+        for (; s < 280; ++s) l[s] = 7;
+        for (; s < 288; ++s) l[s] = 8;
+        build(t.first, l, 288);
+        for (s = 0; s < 30; ++s) l[s] = 5;
+        build(t.second, l, 30);
+        return t;
+    }();
+    return codes(b, out, memberStart, tables.first, tables.second);
+}
+
+bool dynamicBlock(Bits &b, QByteArray &out, qsizetype memberStart)
+{
+    static const short ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    const int nlen = b.take(5) + 257, ndist = b.take(5) + 1, ncode = b.take(4) + 4;
+    if (b.overrun || nlen > 286 || ndist > 30) return false;
+
+    short lengths[320]{};
+    for (int i = 0; i < ncode; ++i) lengths[ORDER[i]] = short(b.take(3));
+    Huffman lens, dists;
+    if (build(lens, lengths, 19) != 0) return false;
+
+    int index = 0;
+    while (index < nlen + ndist) {
+        int sym = decode(b, lens);
+        if (sym < 0 || b.overrun) return false;
+        if (sym < 16) {
+            lengths[index++] = short(sym);
+            continue;
+        }
+        short len = 0;
+        if (sym == 16) {
+            if (index == 0) return false;
+            len = lengths[index - 1];
+            sym = 3 + b.take(2);
+        } else if (sym == 17) {
+            sym = 3 + b.take(3);
+        } else {
+            sym = 11 + b.take(7);
+        }
+        if (index + sym > nlen + ndist) return false;
+        while (sym--) lengths[index++] = len;
+    }
+    if (lengths[256] == 0) return false;
+
+    // Incomplete codes are only allowed for a single length
+    int err = build(lens, lengths, nlen);
+    if (err < 0 || (err > 0 && nlen - lens.count[0] != 1)) return false;
+    err = build(dists, lengths + nlen, ndist);
+    if (err < 0 || (err > 0 && ndist - dists.count[0] != 1)) return false;
+    return codes(b, out, memberStart, lens, dists);
+}
+
+} // namespace
+
+bool decompress(const QByteArray &gz, QByteArray &out, QString *error)
+{
+    auto fail = [&](const char *why) { if (error) *error = QString::fromLatin1(why); return false; };
+    const auto *p = reinterpret_cast<const quint8 *>(gz.constData());
+    const std::size_t size = std::size_t(gz.size());
+    out.clear();
+    out.reserve(gz.size() * 4);
+
+    std::size_t at = 0;
+    // Some writers pad after the last member with zeros
+    while (at + 18 <= size && p[at] == 0x1F && p[at + 1] == 0x8B) {
+        if (p[at + 2] != 8) return fail("not deflate");
+        const quint8 flags = p[at + 3];
+        std::size_t i = at + 10;
+        if ((flags & 0x04) && i + 2 <= size) i += 2 + (std::size_t(p[i]) | std::size_t(p[i + 1]) << 8);
+        for (int f : {0x08, 0x10})
+            if (flags & f) { while (i < size && p[i]) ++i; ++i; }
+        if (flags & 0x02) i += 2;
+        if (i >= size) return fail("truncated header");
+
+        Bits b{p + i, size - i};
+        const qsizetype start = out.size();
+        bool last = false;
+        while (!last) {
+            last = b.take(1);
+            const int type = b.take(2);
+            bool ok = false;
+            if (type == 0) {
+                b.alignToByte();
+                if (b.pos + 4 > b.size) return fail("truncated");
+                const std::size_t len = std::size_t(b.p[b.pos]) | std::size_t(b.p[b.pos + 1]) << 8;
+                const std::size_t nlen = std::size_t(b.p[b.pos + 2]) | std::size_t(b.p[b.pos + 3]) << 8;
+                b.pos += 4;
+                ok = len == (~nlen & 0xFFFF) && b.pos + len <= b.size;
+                if (ok) out.append(reinterpret_cast<const char *>(b.p + b.pos), qsizetype(len));
+                b.pos += len;
+            } else if (type == 1) {
+                ok = fixedBlock(b, out, start);
+            } else if (type == 2) {
+                ok = dynamicBlock(b, out, start);
+            }
+            if (!ok || b.overrun) return fail("corrupt or truncated data");
+        }
+
+        at = i + b.pos;
+        if (at + 8 > size) return fail("truncated");
+        const auto le32 = [&](std::size_t k) {
+            return std::uint32_t(p[k]) | std::uint32_t(p[k + 1]) << 8 | std::uint32_t(p[k + 2]) << 16
+                   | std::uint32_t(p[k + 3]) << 24;
+        };
+        if (le32(at) != crc32(out.constData() + start, out.size() - start)) return fail("CRC mismatch");
+        if (le32(at + 4) != std::uint32_t(out.size() - start)) return fail("length mismatch");
+        at += 8;
+    }
+    if (at == 0) return fail("not a gzip file");
+    return true;
+}
+
+} // namespace gzip
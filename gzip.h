@@ -0,0 +1,35 @@
+#ifndef GZIP_H
+#define GZIP_H
+
+// gzip (RFC 1952) files without an external gzip or a zlib dependency.
+//
+// Deflate comes from qCompress: its zlib stream minus the length prefix,
+// the two-byte header and the Adler-32 trailer is a raw deflate stream,
+// which gets a gzip header and a CRC-32 trailer. Files are written as a
+// series of members of at most CHUNK bytes each, which gzip -d and zcat
+// read as one file, so memory stays bounded however large the log grew.
+//
+// Reading needs raw inflate, which qUncompress can't do without the
+// Adler-32 of the data it hasn't produced yet, so decompress() carries a
+// small table-free inflater (after zlib's contrib/puff). It is slower than
+// zlib but only runs on log files, off the GUI thread.
+
+#include <QByteArray>
+#include <QString>
+
+namespace gzip {
+
+inline constexpr qint64 CHUNK = 1024 * 1024;
+
+// One gzip member holding `data`.
+QByteArray compress(const QByteArray &data);
+
+// Replaces `path` with `path`.gz; on failure the original is left alone.
+bool compressFile(const QString &path, QString *error);
+
+// Every member of a gzip file, concatenated; CRCs are checked.
+bool decompress(const QByteArray &gz, QByteArray &out, QString *error);
+
+} // namespace gzip
+
+#endif // GZIP_H
@@ -0,0 +1,88 @@
+#include "latencyprobe.h"
+
+#include <algorithm>
+
+// An input that produced no slot call within this window (clicks on
+// disabled buttons, drags) is not paired with a later, unrelated slot.
+static const std::int64_t INPUT_STALE_NS = 100'000'000;
+
+std::int64_t LatencyProbe::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void LatencyProbe::markInput()
+{
+    inputNs = now();
+}
+
+void LatencyProbe::markInputAt(std::int64_t steadyNs)
+{
+    inputNs = steadyNs;
+}
+
+void LatencyProbe::markSlot()
+{
+    const std::int64_t t = now();
+    if (inputNs && t - inputNs > INPUT_STALE_NS) inputNs = 0;
+    slotNs = t;
+    enqueueNs = 0;
+    outstanding = 0;
+}
+
+void LatencyProbe::markEnqueue(std::int64_t bytes, std::int64_t queuedBefore)
+{
+    const std::int64_t t = now();
+    if (!slotNs || t - slotNs > INPUT_STALE_NS) return;   // not operator-driven
+    if (!enqueueNs) {
+        enqueueNs = t;
+        outstanding = queuedBefore;
+    }
+    outstanding += bytes;
+}
+
+void LatencyProbe::bytesWritten(std::int64_t bytes)
+{
+    if (!enqueueNs) return;
+    outstanding -= bytes;
+    if (outstanding <= 0) complete(now());
+}
+
+void LatencyProbe::complete(std::int64_t writtenNs)
+{
+    // Without an input stamp (keyboard, programmatic) the total starts at the slot.
+    const std::int64_t start = inputNs ? inputNs : slotNs;
+    window[InputToSlot][next]      = inputNs ? slotNs - inputNs : 0;
+    window[SlotToEnqueue][next]    = enqueueNs - slotNs;
+    window[EnqueueToWritten][next] = writtenNs - enqueueNs;
+    window[Total][next]            = writtenNs - start;
+    next = (next + 1) % WINDOW;
+    filled = std::min(filled + 1, WINDOW);
+    inputNs = slotNs = enqueueNs = 0;
+    outstanding = 0;
+}
+
+LatencyProbe::Summary LatencyProbe::summary(Segment s) const
+{
+    Summary out;
+    out.count = filled;
+    if (!filled) return out;
+
+    std::array<std::int64_t, WINDOW> v;
+    std::copy_n(window[s].begin(), filled, v.begin());
+    std::sort(v.begin(), v.begin() + filled);
+    auto pct = [&](double p) { return double(v[std::min(filled - 1, int(p * filled))]) / 1e6; };
+    out.p50 = pct(0.50);
+    out.p95 = pct(0.95);
+    out.p99 = pct(0.99);
+    out.max = double(v[filled - 1]) / 1e6;
+
+    static const std::int64_t edges[] = {1'000'000, 2'000'000, 4'000'000, 8'000'000, FRAME_BUDGET_NS};
+    for (int i = 0; i < filled; ++i) {
+        int b = 0;
+        while (b < 5 && v[i] >= edges[b]) ++b;
+        ++out.buckets[b];
+        if (v[i] >= FRAME_BUDGET_NS) ++out.overBudget;
+    }
+    return out;
+}
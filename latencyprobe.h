@@ -0,0 +1,63 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+// Input-to-wire latency of the operator control path.
+//
+// A sample follows one operator action through four stages:
+//   Input    mouse press/release reaches the button (event filter), or
+//            an OSC datagram is read off its socket
+//   Slot     the handler (ptzPressed etc.) starts
+//   Enqueue  sendVisca is about to hand the frame to QSerialPort
+//   Written  bytesWritten reports the frame left for the driver
+// The last N completed samples are kept per segment for the overlay.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+class LatencyProbe
+{
+public:
+    enum Segment { InputToSlot, SlotToEnqueue, EnqueueToWritten, Total, SegmentCount };
+
+    static constexpr std::int64_t FRAME_BUDGET_NS = 16'000'000; // one 60 Hz video frame
+    static constexpr int WINDOW = 256;
+
+    struct Summary
+    {
+        int    count = 0;
+        double p50 = 0, p95 = 0, p99 = 0, max = 0;   // milliseconds
+        int    overBudget = 0;
+        std::array<int, 6> buckets{};                // <1, <2, <4, <8, <16, >=16 ms
+    };
+
+    void markInput();
+    // Input that was stamped earlier, e.g. an OSC datagram when it was read;
+    // `steadyNs` is std::chrono::steady_clock time since its epoch.
+    void markInputAt(std::int64_t steadyNs);
+    void markSlot();
+    // `queuedBefore` is what the port still had to write; bytesWritten drains
+    // that first, so the sample completes when its own bytes are out.
+    void markEnqueue(std::int64_t bytes, std::int64_t queuedBefore);
+    void bytesWritten(std::int64_t bytes);
+
+    Summary summary(Segment s) const;
+    int samples() const { return filled; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static std::int64_t now();
+    void complete(std::int64_t writtenNs);
+
+    // Stage timestamps of the sample in flight; 0 = not reached yet.
+    std::int64_t inputNs = 0;
+    std::int64_t slotNs = 0;
+    std::int64_t enqueueNs = 0;
+    std::int64_t outstanding = 0;   // bytes of this sample not yet written
+
+    std::array<std::array<std::int64_t, WINDOW>, SegmentCount> window{};
+    int next = 0;
+    int filled = 0;
+};
+
+#endif // LATENCYPROBE_H
@@ -0,0 +1,570 @@
+#include "linkengine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+struct LinkEngine::Link {
+    LinkId   id = -1;
+    Reactor *reactor = nullptr;
+    int      reactorIndex = -1;
+
+    // Send queue: send() appends, the reactor pops
+    std::mutex txMutex;
+    std::array<std::array<visca::Byte, visca::MAX_FRAME>, QUEUE_FRAMES> tx{};
+    std::array<std::uint8_t, QUEUE_FRAMES> txSize{};
+    std::size_t txHead = 0, txCount = 0;
+
+    // Reactor thread only, once add() has registered the link
+    int  fd = -1;
+    std::size_t written = 0;          // of the head frame
+    std::array<visca::Byte, RX_BYTES> rx{};
+    std::size_t rxSize = 0;
+    bool connecting = false;          // TCP connect() in flight
+    bool writable = true;             // false from EAGAIN until EPOLLOUT
+    bool runnable = false;            // in the reactor's write round
+
+    std::atomic<bool> open{true};
+    std::atomic<bool> posted{false};  // waiting in Reactor::posts
+    std::atomic<std::uint64_t> framesTx{0}, framesRx{0}, bytesTx{0}, bytesRx{0};
+    std::atomic<std::uint64_t> dropped{0}, garbage{0};
+};
+
+struct LinkEngine::Reactor {
+    int epollFd = -1;
+    int wakeFd = -1;                  // eventfd; send() and close() ring it
+    std::thread thread;
+    std::mutex mutex;
+    std::vector<Link *> posts;        // guarded by mutex
+    bool stopping = false;            // guarded by mutex
+    std::atomic<int> links{0};
+    std::vector<Link *> dead;         // shut, freed by reap() at the end of a pass
+};
+
+// Keeps a link from being freed while a call from another thread uses it;
+// empty when the id is stale. Pairs with reap(): the slot is cleared before
+// `users` is checked there and `users` is raised before the slot is read
+// here, so one of the two always sees the other (both seq_cst).
+struct LinkEngine::Pin {
+    Slot *slot = nullptr;
+    Link *link = nullptr;
+
+    Pin(const LinkEngine &e, LinkId id)
+    {
+        if (id < 0) return;
+        Slot &s = e.slots[std::size_t(id % MAX_LINKS)];
+        s.users.fetch_add(1);
+        Link *l = s.link.load();
+        if (l && l->id == id) {
+            slot = &s;
+            link = l;
+        } else {
+            s.users.fetch_sub(1);
+        }
+    }
+    ~Pin() { if (slot) slot->users.fetch_sub(1); }
+    Pin(const Pin &) = delete;
+    Pin &operator=(const Pin &) = delete;
+};
+
+static void bump(std::atomic<std::uint64_t> &c, std::uint64_t n = 1)
+{
+    c.fetch_add(n, std::memory_order_relaxed);
+}
+
+static std::string errorText(int err)
+{
+    return std::generic_category().message(err);
+}
+
+std::size_t LinkEngine::bytesPerLink()
+{
+    return sizeof(Link);
+}
+
+bool LinkEngine::send(LinkId id, const visca::Byte *frame, std::size_t size)
+{
+    const Pin pin(*this, id);
+    Link *l = pin.link;
+    if (!l || !l->open.load(std::memory_order_acquire)) return false;
+    if (size == 0 || size > visca::MAX_FRAME) {
+        bump(l->dropped);
+        return false;
+    }
+    {
+        std::lock_guard lock(l->txMutex);
+        if (l->txCount == QUEUE_FRAMES) {
+            bump(l->dropped);
+            return false;
+        }
+        const std::size_t slot = (l->txHead + l->txCount++) % QUEUE_FRAMES;
+        std::memcpy(l->tx[slot].data(), frame, size);
+        l->txSize[slot] = std::uint8_t(size);
+    }
+    post(*l);
+    return true;
+}
+
+void LinkEngine::close(LinkId id)
+{
+    const Pin pin(*this, id);
+    Link *l = pin.link;
+    if (!l || !l->open.exchange(false)) return;
+    post(*l);
+}
+
+LinkEngine::Stats LinkEngine::stats(LinkId id) const
+{
+    Stats s;
+    const Pin pin(*this, id);
+    Link *l = pin.link;
+    if (!l) return s;
+    s.framesTx = l->framesTx.load(std::memory_order_relaxed);
+    s.framesRx = l->framesRx.load(std::memory_order_relaxed);
+    s.bytesTx = l->bytesTx.load(std::memory_order_relaxed);
+    s.bytesRx = l->bytesRx.load(std::memory_order_relaxed);
+    s.dropped = l->dropped.load(std::memory_order_relaxed);
+    s.garbage = l->garbage.load(std::memory_order_relaxed);
+    s.reactor = l->reactorIndex;
+    s.open = l->open.load(std::memory_order_relaxed);
+    std::lock_guard lock(l->txMutex);
+    s.queued = l->txCount;
+    return s;
+}
+
+#if defined(__linux__)
+
+bool LinkEngine::supported()
+{
+    return true;
+}
+
+LinkEngine::LinkEngine(Handlers h, int count)
+    : handlers(std::move(h))
+{
+    freeSlots.reserve(MAX_LINKS);
+    for (int i = MAX_LINKS - 1; i >= 0; --i) freeSlots.push_back(i);
+    if (count <= 0) count = int(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 0; i < count; ++i) {
+        auto r = std::make_unique<Reactor>();
+        r->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        r->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (r->epollFd < 0 || r->wakeFd < 0) {
+            if (r->epollFd >= 0) ::close(r->epollFd);
+            if (r->wakeFd >= 0) ::close(r->wakeFd);
+            break;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;        // the wake-up, not a link
+        epoll_ctl(r->epollFd, EPOLL_CTL_ADD, r->wakeFd, &ev);
+        r->posts.reserve(MAX_LINKS);
+        Reactor &ref = *r;
+        reactors.push_back(std::move(r));
+        ref.thread = std::thread([this, &ref] { run(ref); });
+    }
+}
+
+LinkEngine::~LinkEngine()
+{
+    for (auto &r : reactors) {
+        {
+            std::lock_guard lock(r->mutex);
+            r->stopping = true;
+        }
+        const std::uint64_t one = 1;
+        (void)::write(r->wakeFd, &one, sizeof one);
+    }
+    for (auto &r : reactors) {
+        r->thread.join();
+        ::close(r->epollFd);
+        ::close(r->wakeFd);
+    }
+    for (Slot &s : slots) {
+        Link *l = s.link.load(std::memory_order_acquire);
+        if (!l) continue;
+        if (l->fd >= 0) ::close(l->fd);
+        delete l;
+    }
+    for (auto &r : reactors)
+        for (Link *l : r->dead) delete l;
+}
+
+static speed_t speedOf(int baud)
+{
+    switch (baud) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    default:     return B0;
+    }
+}
+
+LinkEngine::LinkId LinkEngine::openSerial(const std::string &path, int baud, std::string *error)
+{
+    const speed_t speed = speedOf(baud);
+    if (speed == B0) {
+        if (error) *error = "unsupported baud rate " + std::to_string(baud);
+        return -1;
+    }
+    const int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        if (error) *error = path + ": " + errorText(errno);
+        return -1;
+    }
+    termios t{};
+    if (tcgetattr(fd, &t) < 0) {
+        if (error) *error = path + ": " + errorText(errno);
+        ::close(fd);
+        return -1;
+    }
+    // 8N1 raw, no flow control, as QSerialPort sets it up for MainWindow
+    cfmakeraw(&t);
+    t.c_cflag |= CLOCAL | CREAD;
+    t.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    t.c_cc[VMIN] = 1;
+    t.c_cc[VTIME] = 0;
+    cfsetispeed(&t, speed);
+    cfsetospeed(&t, speed);
+    if (tcsetattr(fd, TCSANOW, &t) < 0) {
+        if (error) *error = path + ": " + errorText(errno);
+        ::close(fd);
+        return -1;
+    }
+    ioctl(fd, TIOCEXCL);              // keep other instances off the port
+    tcflush(fd, TCIOFLUSH);
+    return add(fd, false, error);
+}
+
+LinkEngine::LinkId LinkEngine::openTcp(const std::string &host, int port, std::string *error)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *found = nullptr;
+    const int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found);
+    if (rc != 0) {
+        if (error) *error = host + ": " + gai_strerror(rc);
+        return -1;
+    }
+    int fd = -1;
+    bool connecting = false;
+    std::string why = host + ": no address";
+    for (addrinfo *a = found; a; a = a->ai_next) {
+        fd = ::socket(a->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) { why = host + ": " + errorText(errno); continue; }
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) break;
+        if (errno == EINPROGRESS) { connecting = true; break; }
+        why = host + ": " + errorText(errno);
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(found);
+    if (fd < 0) {
+        if (error) *error = why;
+        return -1;
+    }
+    // VISCA frames are tiny and latency-bound; never let Nagle hold one back
+    const int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof on);
+    return add(fd, connecting, error);
+}
+
+LinkEngine::LinkId LinkEngine::add(int fd, bool connecting, std::string *error)
+{
+    if (reactors.empty()) {
+        if (error) *error = "no reactor threads";
+        ::close(fd);
+        return -1;
+    }
+    LinkId id;
+    {
+        std::lock_guard lock(slotMutex);
+        if (freeSlots.empty()) {
+            if (error) *error = "too many links (" + std::to_string(MAX_LINKS) + ")";
+            ::close(fd);
+            return -1;
+        }
+        const int slot = freeSlots.back();
+        freeSlots.pop_back();
+        // Generation in the high bits, kept positive
+        id = (slots[std::size_t(slot)].generation & 0x7FFFFF) * MAX_LINKS + slot;
+    }
+
+    // The least loaded reactor; links never move, so their frames stay ordered
+    int best = 0;
+    for (int i = 1; i < int(reactors.size()); ++i)
+        if (reactors[i]->links.load() < reactors[best]->links.load()) best = i;
+    Reactor &r = *reactors[best];
+
+    auto *l = new Link;
+    l->id = id;
+    l->reactor = &r;
+    l->reactorIndex = best;
+    l->fd = fd;
+    l->connecting = connecting;
+    l->writable = !connecting;
+    // Counted before the reactor can see it, so shut() never goes below zero
+    r.links.fetch_add(1);
+    live.fetch_add(1, std::memory_order_relaxed);
+    slots[std::size_t(id % MAX_LINKS)].link.store(l);
+
+    // Edge-triggered: the reactor drains reads and writes until EAGAIN
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = l;
+    if (epoll_ctl(r.epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        if (error) *error = errorText(errno);
+        // Not on the reactor yet; only a Pin can be holding it
+        Slot &s = slots[std::size_t(id % MAX_LINKS)];
+        s.link.store(nullptr);
+        while (s.users.load() != 0) std::this_thread::yield();
+        r.links.fetch_sub(1);
+        live.fetch_sub(1, std::memory_order_relaxed);
+        ::close(fd);
+        delete l;
+        release(id % MAX_LINKS);
+        return -1;
+    }
+    return id;
+}
+
+void LinkEngine::release(int slot)
+{
+    std::lock_guard lock(slotMutex);
+    ++slots[std::size_t(slot)].generation;
+    freeSlots.push_back(slot);
+}
+
+void LinkEngine::post(Link &l)
+{
+    if (l.posted.exchange(true, std::memory_order_acq_rel)) return;   // already on its way
+    Reactor &r = *l.reactor;
+    {
+        std::lock_guard lock(r.mutex);
+        r.posts.push_back(&l);
+    }
+    const std::uint64_t one = 1;
+    (void)::write(r.wakeFd, &one, sizeof one);
+}
+
+void LinkEngine::shut(Link &l, const std::string &reason)
+{
+    if (l.fd < 0) return;
+    epoll_ctl(l.reactor->epollFd, EPOLL_CTL_DEL, l.fd, nullptr);
+    ::close(l.fd);
+    l.fd = -1;
+    l.open.store(false, std::memory_order_release);
+    l.reactor->links.fetch_sub(1);
+    live.fetch_sub(1, std::memory_order_relaxed);
+    // No new Pin can find it from here on; reap() waits out the ones that did
+    slots[std::size_t(l.id % MAX_LINKS)].link.store(nullptr);
+    l.reactor->dead.push_back(&l);
+    if (handlers.closed) handlers.closed(l.id, reason);
+}
+
+void LinkEngine::reap(Reactor &r)
+{
+    for (Link *l : r.dead) {
+        const int slot = l->id % MAX_LINKS;
+        while (slots[std::size_t(slot)].users.load() != 0) std::this_thread::yield();
+        {
+            // A send() that got in before shut() may have posted it since
+            std::lock_guard lock(r.mutex);
+            std::erase(r.posts, l);
+        }
+        delete l;
+        release(slot);
+    }
+    r.dead.clear();
+}
+
+void LinkEngine::receive(Link &l)
+{
+    visca::Byte buf[256];
+    while (l.fd >= 0) {
+        const ssize_t n = ::read(l.fd, buf, sizeof buf);
+        if (n == 0) {
+            shut(l, "end of stream");
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) shut(l, errorText(errno));
+            return;
+        }
+        bump(l.bytesRx, std::uint64_t(n));
+        for (ssize_t i = 0; i < n; ++i) {
+            if (l.rxSize == RX_BYTES) {          // no terminator: line noise or wrong baud
+                bump(l.garbage, l.rxSize);
+                l.rxSize = 0;
+            }
+            l.rx[l.rxSize++] = buf[i];
+            if (buf[i] != visca::TERMINATOR) continue;
+            bump(l.framesRx);
+            if (handlers.frame) handlers.frame(l.id, l.rx.data(), l.rxSize);
+            l.rxSize = 0;
+        }
+    }
+}
+
+bool LinkEngine::writeOne(Link &l)
+{
+    if (l.fd < 0 || !l.writable || l.connecting) return false;
+    std::unique_lock lock(l.txMutex);
+    if (!l.txCount) return false;
+    const std::size_t size = l.txSize[l.txHead];
+    const ssize_t n = ::write(l.fd, l.tx[l.txHead].data() + l.written, size - l.written);
+    if (n < 0) {
+        if (errno == EINTR) return true;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            l.writable = false;
+            return false;
+        }
+        const int err = errno;
+        lock.unlock();
+        shut(l, errorText(err));
+        return false;
+    }
+    l.written += std::size_t(n);
+    if (l.written < size) {                      // buffer full mid-frame; EPOLLOUT resumes it
+        l.writable = false;
+        return false;
+    }
+    l.written = 0;
+    l.txHead = (l.txHead + 1) % QUEUE_FRAMES;
+    --l.txCount;
+    bump(l.framesTx);
+    bump(l.bytesTx, size);
+    const bool more = l.txCount > 0;
+    lock.unlock();
+    if (handlers.written)
+        handlers.written(l.id, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch()).count());
+    return more;
+}
+
+void LinkEngine::run(Reactor &r)
+{
+    std::array<epoll_event, 64> events;
+    std::vector<Link *> posts, ready;
+    posts.reserve(MAX_LINKS);
+    ready.reserve(MAX_LINKS);
+
+    auto schedule = [&](Link &l) {
+        if (l.runnable || l.fd < 0 || !l.writable || l.connecting) return;
+        {
+            std::lock_guard lock(l.txMutex);
+            if (!l.txCount) return;
+        }
+        l.runnable = true;
+        ready.push_back(&l);
+    };
+
+    for (;;) {
+        const int n = epoll_wait(r.epollFd, events.data(), int(events.size()), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            Link *l = static_cast<Link *>(events[i].data.ptr);
+            if (!l) {
+                std::uint64_t count;
+                (void)::read(r.wakeFd, &count, sizeof count);
+                {
+                    std::lock_guard lock(r.mutex);
+                    if (r.stopping) return;
+                    posts.swap(r.posts);
+                }
+                for (Link *p : posts) {
+                    // Cleared before looking at the queue, so a later send() posts again
+                    p->posted.store(false, std::memory_order_release);
+                    if (!p->open.load(std::memory_order_acquire)) shut(*p, "closed");
+                    else schedule(*p);
+                }
+                posts.clear();
+                continue;
+            }
+            if (l->fd < 0) continue;
+            const std::uint32_t ev = events[i].events;
+            if ((ev & (EPOLLOUT | EPOLLERR)) && l->connecting) {
+                int err = 0;
+                socklen_t len = sizeof err;
+                getsockopt(l->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err) {
+                    shut(*l, errorText(err));
+                    continue;
+                }
+                l->connecting = false;
+            }
+            if (ev & EPOLLOUT) {
+                l->writable = true;
+                schedule(*l);
+            }
+            if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) receive(*l);
+        }
+
+        // Fair write rounds: one frame per link per pass until every
+        // queue is empty or its descriptor is full
+        while (!ready.empty()) {
+            std::size_t keep = 0;
+            for (Link *l : ready) {
+                if (writeOne(*l)) ready[keep++] = l;
+                else l->runnable = false;
+            }
+            ready.resize(keep);
+        }
+
+        // Nothing of this pass refers to a shut link any more
+        if (!r.dead.empty()) reap(r);
+    }
+}
+
+#else
+
+bool LinkEngine::supported() { return false; }
+LinkEngine::LinkEngine(Handlers h, int) : handlers(std::move(h)) {}
+LinkEngine::~LinkEngine() {}
+
+LinkEngine::LinkId LinkEngine::openSerial(const std::string &, int, std::string *error)
+{
+    if (error) *error = "the link engine needs Linux (epoll)";
+    return -1;
+}
+
+LinkEngine::LinkId LinkEngine::openTcp(const std::string &, int, std::string *error)
+{
+    if (error) *error = "the link engine needs Linux (epoll)";
+    return -1;
+}
+
+LinkEngine::LinkId LinkEngine::add(int, bool, std::string *) { return -1; }
+void LinkEngine::post(Link &) {}
+void LinkEngine::run(Reactor &) {}
+void LinkEngine::receive(Link &) {}
+bool LinkEngine::writeOne(Link &) { return false; }
+void LinkEngine::shut(Link &, const std::string &) {}
+void LinkEngine::reap(Reactor &) {}
+void LinkEngine::release(int) {}
+
+#endif
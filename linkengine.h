@@ -0,0 +1,119 @@
+#ifndef LINKENGINE_H
+#define LINKENGINE_H
+
+// Many VISCA links from a few threads.
+//
+// MainWindow drives one camera through one QSerialPort on the GUI thread.
+// LinkEngine is the backend for running dozens of links in one process:
+// serial ports and TCP links (serial-over-IP servers, cameras that take raw
+// VISCA on a TCP port) are spread over a fixed pool of reactors, one thread
+// with one epoll set each, by default one per core. A reactor sleeps in
+// epoll_wait until a link is readable or writable or send() hands it work,
+// so idle links cost nothing and CPU scales with traffic, not link count.
+//
+// Each link has a fixed send queue of QUEUE_FRAMES frames and a fixed
+// receive buffer; nothing grows with traffic, so memory per link is
+// bytesPerLink() whatever the cameras do. A full queue makes send() fail
+// (counted as dropped) instead of buffering without bound; callers that
+// coalesce drive updates should rarely see it. Writes are round-robin, one
+// frame per link per pass, so a link with a deep queue cannot starve the
+// others on its reactor.
+//
+// Received bytes are split on FF and handed to Handlers::frame on the
+// link's reactor thread; Handlers::written gets the steady_clock time at
+// which a sent frame's last byte went to the kernel. A link always stays on
+// the same reactor, so its frames arrive in order and never concurrently,
+// and a frame's written call comes before any reply to it. Handlers must be
+// quick and must not call close() on the engine being destroyed. send(),
+// close() and stats() may be called from any thread. Linux only; open*()
+// fails elsewhere.
+//
+// A link is freed on its reactor once it has shut and no send() or stats()
+// still holds it, and its slot goes back to a free list. Ids carry the
+// slot's generation, so a stale id is refused rather than reaching
+// whichever link reuses the slot. At most MAX_LINKS are open at once.
+
+#include "visca.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class LinkEngine
+{
+public:
+    using LinkId = int;
+    static constexpr int MAX_LINKS = 256;
+    static constexpr std::size_t QUEUE_FRAMES = 32;           // per link
+    static constexpr std::size_t RX_BYTES = 2 * visca::MAX_FRAME;
+
+    struct Handlers {
+        std::function<void(LinkId, const visca::Byte *, std::size_t)> frame;
+        std::function<void(LinkId, const std::string &reason)> closed;   // error, EOF or close()
+        std::function<void(LinkId, std::int64_t steadyNs)> written;       // optional
+    };
+
+    struct Stats {
+        std::uint64_t framesTx = 0, framesRx = 0;
+        std::uint64_t bytesTx = 0, bytesRx = 0;
+        std::uint64_t dropped = 0;        // send() refused: queue full or frame too long
+        std::uint64_t garbage = 0;        // received bytes discarded without a terminator
+        std::size_t   queued = 0;
+        int           reactor = -1;
+        bool          open = false;
+    };
+
+    // `reactors` 0 = one per core.
+    explicit LinkEngine(Handlers h, int reactors = 0);
+    ~LinkEngine();
+
+    static bool supported();
+    static std::size_t bytesPerLink();
+
+    int reactorCount() const { return int(reactors.size()); }
+    int linkCount() const { return live.load(std::memory_order_relaxed); }
+
+    // Return the new link's id, or -1 with `error` set.
+    LinkId openSerial(const std::string &path, int baud, std::string *error = nullptr);
+    LinkId openTcp(const std::string &host, int port, std::string *error = nullptr);
+
+    // Queues one frame; false when the link is closed or its queue is full.
+    bool send(LinkId id, const visca::Byte *frame, std::size_t size);
+    void close(LinkId id);
+    // Zeros once the link has been freed.
+    Stats stats(LinkId id) const;
+
+private:
+    struct Link;
+    struct Reactor;
+    struct Pin;
+
+    struct Slot {
+        std::atomic<Link *> link{nullptr};
+        std::atomic<int>    users{0};        // Pins holding `link` off the reactor
+        int                 generation = 0;  // guarded by slotMutex
+    };
+
+    LinkId add(int fd, bool connecting, std::string *error);
+    void run(Reactor &r);
+    void post(Link &l);
+    void receive(Link &l);
+    bool writeOne(Link &l);     // true when more frames wait
+    void shut(Link &l, const std::string &reason);
+    void reap(Reactor &r);      // frees the reactor's shut links
+    void release(int slot);
+
+    Handlers handlers;
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    mutable std::array<Slot, MAX_LINKS> slots{};
+    std::mutex slotMutex;
+    std::vector<int> freeSlots;              // guarded by slotMutex; lowest on top
+    std::atomic<int> live{0};
+};
+
+#endif // LINKENGINE_H
@@ -0,0 +1,245 @@
+#include "linksoak.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+static const int DRAIN_MS = 500;    // longer than any simulated completion
+
+LinkSoak::LinkSoak(const SoakRunner::Options &o, QObject *parent)
+    : QObject(parent), opt(o)
+{
+    actionTimer.setInterval(1000 / std::max(1, opt.actionsHz));
+    pollTimer.setInterval(1000 / std::max(1, opt.pollHz));
+    connect(&actionTimer, &QTimer::timeout, this, &LinkSoak::act);
+    connect(&pollTimer,   &QTimer::timeout, this, &LinkSoak::poll);
+}
+
+LinkSoak::~LinkSoak()
+{
+    engine.reset();   // stop the reactors before the stats they write go away
+}
+
+void LinkSoak::start()
+{
+    if (!LinkEngine::supported()) {
+        std::fprintf(stderr, "soak: the link engine is not available on this platform\n");
+        QCoreApplication::exit(2);
+        return;
+    }
+
+    LinkEngine::Handlers h;
+    h.frame = [this](LinkEngine::LinkId id, const visca::Byte *f, std::size_t n) {
+        Camera &c = *cameras[std::size_t(id)];
+        std::lock_guard lock(c.statsMutex);
+        const visca::SentFrame answered = c.sent.retire(f, n);
+        c.stats.onRx(n, visca::decode(f, n, answered.inquiry), answered);
+    };
+    h.closed = [this](LinkEngine::LinkId, const std::string &) { ++linksLost; };
+    engine = std::make_unique<LinkEngine>(std::move(h), opt.reactors);
+
+    // A fresh engine hands out ids 0, 1, 2..., so they index `cameras`
+    cameras.reserve(std::size_t(opt.links));
+    for (int i = 0; i < opt.links; ++i) {
+        auto c = std::make_unique<Camera>();
+        c->sim = std::make_unique<ViscaSimulator>(ViscaSimulator::Options{.errorRate = opt.errorRate});
+        if (!c->sim->open()) {
+            std::fprintf(stderr, "soak: cannot create a pseudo-terminal for simulator %d\n", i + 1);
+            QCoreApplication::exit(2);
+            return;
+        }
+        cameras.push_back(std::move(c));
+        std::string error;
+        cameras.back()->id = engine->openSerial(cameras.back()->sim->devicePath().toStdString(), 9600, &error);
+        if (cameras.back()->id != i) {
+            std::fprintf(stderr, "soak: %s\n", error.c_str());
+            QCoreApplication::exit(2);
+            return;
+        }
+    }
+
+    rssStartKb = SoakRunner::residentKb();
+    cpuStartMs = cpuMs();
+    clock.start();
+    actionTimer.start();
+    pollTimer.start();
+    QTimer::singleShot(opt.seconds * 1000, this, &LinkSoak::finish);
+}
+
+void LinkSoak::send(Camera &c, const visca::Byte *frame, std::size_t size)
+{
+    if (!engine) return;
+    // Held across the send so a fast reply can't beat its frame into the tracker
+    std::lock_guard lock(c.statsMutex);
+    if (!engine->send(c.id, frame, size)) return;
+    c.sent.push(frame, size);
+    c.stats.onTx(size);
+}
+
+void LinkSoak::act()
+{
+    ++actions;
+    for (auto &cp : cameras) {
+        Camera &c = *cp;
+        const int r = int(rng.bounded(10));
+        const int stopMs = int(rng.bounded(30, 200));
+        if (r < 5) {
+            int dx = 0, dy = 0;
+            while (!dx && !dy) {
+                dx = int(rng.bounded(3)) - 1;
+                dy = int(rng.bounded(3)) - 1;
+            }
+            const auto f = visca::PanTiltDrive::encode(1, 0x10, 0x10,
+                dx < 0 ? visca::PAN_LEFT : dx > 0 ? visca::PAN_RIGHT : visca::PAN_STOP,
+                dy < 0 ? visca::TILT_UP : dy > 0 ? visca::TILT_DOWN : visca::TILT_STOP);
+            send(c, f.bytes.data(), f.size());
+            QTimer::singleShot(stopMs, this, [this, &c] {
+                const auto stop = visca::PanTiltDrive::encode(1, 0x10, 0x10, visca::PAN_STOP, visca::TILT_STOP);
+                send(c, stop.bytes.data(), stop.size());
+            });
+        } else if (r < 8) {
+            const auto f = rng.bounded(2) ? visca::ZoomTele::encode(1, 4) : visca::ZoomWide::encode(1, 4);
+            send(c, f.bytes.data(), f.size());
+            QTimer::singleShot(stopMs, this, [this, &c] {
+                const auto stop = visca::ZoomStop::encode(1);
+                send(c, stop.bytes.data(), stop.size());
+            });
+        } else if (r < 9) {
+            const auto f = visca::PresetRecall::encode(1, int(rng.bounded(16)));
+            send(c, f.bytes.data(), f.size());
+        }
+    }
+}
+
+void LinkSoak::poll()
+{
+    ++polls;
+    const auto f = visca::PanTiltPosInq::encode(1);
+    for (auto &c : cameras) send(*c, f.bytes.data(), f.size());
+}
+
+void LinkSoak::finish()
+{
+    driveMs = clock.elapsed();
+    actionTimer.stop();
+    pollTimer.stop();
+    QTimer::singleShot(DRAIN_MS, this, &LinkSoak::report);
+}
+
+double LinkSoak::cpuMs()
+{
+#if defined(Q_OS_UNIX)
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000.0
+           + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000.0;
+#else
+    return 0;
+#endif
+}
+
+void LinkSoak::report()
+{
+    const double secs = std::max<qint64>(1, driveMs) / 1000.0;
+    const double cpu = cpuMs() - cpuStartMs;
+    const qint64 rssGrowth = SoakRunner::residentKb() - rssStartKb;
+
+    // Merge the per-link stats; fairness is the least-served link's share
+    LinkStats all;
+    quint64 minTx = ~quint64(0), maxTx = 0, dropped = 0, garbage = 0, expected = 0, unanswered = 0;
+    for (auto &c : cameras) {
+        const LinkEngine::Stats e = engine->stats(c->id);
+        minTx = std::min<quint64>(minTx, e.framesTx);
+        maxTx = std::max<quint64>(maxTx, e.framesTx);
+        dropped += e.dropped;
+        garbage += e.garbage;
+        expected += c->sim->counters().injectedErrors;
+        std::lock_guard lock(c->statsMutex);
+        const LinkStats &s = c->stats;
+        all.framesTx += s.framesTx;
+        all.framesRx += s.framesRx;
+        all.bytesTx += s.bytesTx;
+        all.bytesRx += s.bytesRx;
+        all.unknownRx += s.unknownRx;
+        unanswered += c->sent.lost() + quint64(c->sent.size());
+        all.latencyCount += s.latencyCount;
+        all.latencySumUs += s.latencySumUs;
+        for (std::size_t i = 0; i < s.errors.size(); ++i) all.errors[i] += s.errors[i];
+        for (std::size_t i = 0; i < s.latency.size(); ++i) all.latency[i] += s.latency[i];
+    }
+    if (cameras.empty()) minTx = 0;
+
+    const double fps = double(all.framesTx) / secs;
+    const double p50 = all.latencyQuantileMs(0.50), p99 = all.latencyQuantileMs(0.99);
+    const double mean = all.latencyCount ? double(all.latencySumUs) / all.latencyCount / 1000.0 : 0;
+    const double fairness = maxTx ? double(minTx) / double(maxTx) : 1.0;
+    const double cpuPerLink = cpu / secs / std::max<std::size_t>(1, cameras.size());
+    // As in SoakRunner: buffer-full, cancelled, no-socket and injected errors are the camera's
+    const quint64 allErrors = std::accumulate(all.errors.begin(), all.errors.end(), quint64(0));
+    expected += all.errors[3] + all.errors[4] + all.errors[5];
+    const qint64 failures = qint64(allErrors - std::min(allErrors, expected))
+                            + qint64(all.unknownRx + unanswered + dropped + garbage) + linksLost;
+
+    QStringList failed;
+    if (opt.minFps >= 0 && fps < opt.minFps)
+        failed << QString("frames/s %1 < %2").arg(fps, 0, 'f', 1).arg(opt.minFps);
+    if (opt.maxP99Ms >= 0 && p99 > opt.maxP99Ms)
+        failed << QString("p99 %1 ms > %2 ms").arg(p99).arg(opt.maxP99Ms);
+    if (opt.maxFailures >= 0 && failures > opt.maxFailures)
+        failed << QString("failures %1 > %2").arg(failures).arg(opt.maxFailures);
+    if (opt.maxRssKb >= 0 && rssGrowth > opt.maxRssKb)
+        failed << QString("rss growth %1 kB > %2 kB").arg(rssGrowth).arg(opt.maxRssKb);
+
+    std::printf("SimplePTZ link soak: %.1f s, %zu links on %d reactors, %lld action rounds, %lld poll rounds\n",
+                secs, cameras.size(), engine->reactorCount(), actions, polls);
+    std::printf("  frames   tx %llu (%.1f/s)  rx %llu  per link tx min %llu max %llu (fairness %.2f)\n",
+                (unsigned long long)all.framesTx, fps, (unsigned long long)all.framesRx,
+                (unsigned long long)minTx, (unsigned long long)maxTx, fairness);
+    std::printf("  latency  p50 <=%.1f ms  p99 <=%.1f ms  mean %.2f ms (%llu replies)\n",
+                p50, p99, mean, (unsigned long long)all.latencyCount);
+    std::printf("  errors   buffer-full %llu  other %llu  undecodable %llu  unanswered %llu  "
+                "dropped %llu  garbage %llu  links lost %d\n",
+                (unsigned long long)all.errors[3],
+                (unsigned long long)(allErrors - std::min(allErrors, expected)),
+                (unsigned long long)all.unknownRx, (unsigned long long)unanswered,
+                (unsigned long long)dropped, (unsigned long long)garbage, linksLost.load());
+    std::printf("  cost     cpu %.2f ms per link-second (simulators included)  "
+                "engine %zu B per link  rss +%lld kB\n",
+                cpuPerLink, LinkEngine::bytesPerLink(), rssGrowth);
+    std::printf("%s%s\n", failed.isEmpty() ? "PASS" : "FAIL: ", qPrintable(failed.join("; ")));
+    std::fflush(stdout);
+
+    if (!opt.reportPath.isEmpty()) {
+        const QJsonObject o{
+            {"seconds", secs}, {"links", int(cameras.size())}, {"reactors", engine->reactorCount()},
+            {"framesTx", qint64(all.framesTx)}, {"framesRx", qint64(all.framesRx)},
+            {"framesPerSec", fps}, {"linkTxMin", qint64(minTx)}, {"linkTxMax", qint64(maxTx)},
+            {"fairness", fairness},
+            {"latencyP50Ms", p50}, {"latencyP99Ms", p99}, {"latencyMeanMs", mean},
+            {"dropped", qint64(dropped)}, {"garbage", qint64(garbage)}, {"linksLost", linksLost.load()},
+            {"failures", failures},
+            {"cpuMsPerLinkSecond", cpuPerLink}, {"engineBytesPerLink", qint64(LinkEngine::bytesPerLink())},
+            {"rssGrowthKb", rssGrowth},
+            {"pass", failed.isEmpty()}, {"failed", QJsonArray::fromStringList(failed)},
+        };
+        QFile f(opt.reportPath);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            f.write(QJsonDocument(o).toJson());
+        else
+            std::fprintf(stderr, "soak: cannot write %s\n", qPrintable(opt.reportPath));
+    }
+
+    engine.reset();
+    QCoreApplication::exit(failed.isEmpty() ? 0 : 1);
+}
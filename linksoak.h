@@ -0,0 +1,69 @@
+#ifndef LINKSOAK_H
+#define LINKSOAK_H
+
+// Multi-link soak: `SimplePTZ --soak <seconds> --soak-links <n>`.
+//
+// Puts n ViscaSimulators behind ptys on one LinkEngine and drives every
+// link with pan/tilt and zoom drives, preset recalls and position polls at
+// the soak rates. Where SoakRunner measures the single-camera window, this
+// measures the engine: aggregate frames/s, how evenly the links were
+// served, reply latency, CPU per link and memory per link. Thresholds and
+// the JSON report work as in SoakRunner.
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include "linkengine.h"
+#include "linkstats.h"
+#include "soakrunner.h"
+#include "viscasim.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class LinkSoak : public QObject
+{
+    Q_OBJECT
+public:
+    LinkSoak(const SoakRunner::Options &opt, QObject *parent = nullptr);
+    ~LinkSoak() override;
+
+    // Starts the run; the application exits with the verdict when it ends.
+    void start();
+
+private:
+    struct Camera {
+        std::unique_ptr<ViscaSimulator> sim;
+        LinkEngine::LinkId id = -1;
+        std::mutex statsMutex;       // sends on the GUI thread, replies on a reactor
+        visca::SentFrames sent;
+        LinkStats stats;
+    };
+
+    void send(Camera &c, const visca::Byte *frame, std::size_t size);
+    void act();
+    void poll();
+    void finish();
+    void report();
+    static double cpuMs();
+
+    SoakRunner::Options opt;
+    std::vector<std::unique_ptr<Camera>> cameras;
+    std::unique_ptr<LinkEngine> engine;
+    std::atomic<int> linksLost{0};
+    QTimer actionTimer;
+    QTimer pollTimer;
+    QElapsedTimer clock;
+    QRandomGenerator rng{0x4C494E4B};
+    qint64 driveMs = 0;
+    qint64 actions = 0;
+    qint64 polls = 0;
+    qint64 rssStartKb = 0;
+    double cpuStartMs = 0;
+};
+
+#endif // LINKSOAK_H
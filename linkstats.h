@@ -0,0 +1,94 @@
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+// Traffic counters for one camera link.
+//
+// Reply latency is measured from a frame's write to the first reply that
+// answers it (ACK, inquiry reply or socket-0 error; completions come later
+// and are not latency). The link's visca::SentFrames pairs the two and
+// keeps the send time; frames it gives up on are its lost() count.
+// Latencies go into fixed 1-2-5 buckets, enough for percentiles in reports
+// and regression checks without keeping every sample.
+
+#include "viscareply.h"
+
+#include <array>
+#include <cstdint>
+
+class LinkStats
+{
+public:
+    // Bucket upper bounds in microseconds; the last bucket is open-ended.
+    static constexpr std::array<std::int64_t, 14> BUCKET_US{
+        100, 200, 500, 1'000, 2'000, 5'000, 10'000, 20'000, 50'000,
+        100'000, 200'000, 500'000, 1'000'000, 2'000'000};
+    static constexpr std::size_t BUCKETS = BUCKET_US.size() + 1;
+
+    std::uint64_t framesTx = 0;
+    std::uint64_t framesRx = 0;
+    std::uint64_t bytesTx = 0;
+    std::uint64_t bytesRx = 0;
+    std::uint64_t unknownRx = 0;                // frames the decoder rejected
+    std::array<std::uint64_t, 8> errors{};      // by errorIndex()
+    std::array<std::uint64_t, BUCKETS> latency{};
+    std::uint64_t latencyCount = 0;
+    std::int64_t  latencySumUs = 0;
+
+    void onTx(std::size_t bytes)
+    {
+        ++framesTx;
+        bytesTx += bytes;
+    }
+
+    // `answered` is what SentFrames::retire() paired the reply with. Returns
+    // the reply latency in microseconds, -1 when the frame answers nothing.
+    std::int64_t onRx(std::size_t bytes, const visca::Reply &r, const visca::SentFrame &answered,
+                      std::int64_t nowNs = visca::SentFrames::now())
+    {
+        ++framesRx;
+        bytesRx += bytes;
+        if (r.kind == visca::ReplyKind::Unknown) ++unknownRx;
+        else if (r.kind == visca::ReplyKind::Error) ++errors[errorIndex(r.error)];
+        if (!answered) return -1;
+        const std::int64_t us = (nowNs - answered.sentNs) / 1000;
+        addLatency(us);
+        return us;
+    }
+
+    // 0..5 = ErrorKind 01..05, 6 = not executable (41), 7 = other
+    static int errorIndex(visca::ErrorKind e)
+    {
+        const int v = int(e);
+        return v >= 1 && v <= 5 ? v : (e == visca::ErrorKind::NotExecutable ? 6 : 7);
+    }
+
+    static std::size_t bucketOf(std::int64_t us)
+    {
+        std::size_t b = 0;
+        while (b < BUCKET_US.size() && us > BUCKET_US[b]) ++b;
+        return b;
+    }
+
+    // Upper bound of the bucket holding quantile q, in milliseconds.
+    double latencyQuantileMs(double q) const
+    {
+        if (!latencyCount) return 0;
+        const std::uint64_t rank = std::uint64_t(q * double(latencyCount - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < BUCKET_US.size(); ++b) {
+            seen += latency[b];
+            if (seen >= rank) return double(BUCKET_US[b]) / 1000.0;
+        }
+        return double(BUCKET_US.back()) / 1000.0;   // open-ended bucket
+    }
+
+private:
+    void addLatency(std::int64_t us)
+    {
+        ++latency[bucketOf(us)];
+        ++latencyCount;
+        latencySumUs += us;
+    }
+};
+
+#endif // LINKSTATS_H
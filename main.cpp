@@ -1,8 +1,142 @@
 #include "mainwindow.h"
+#include "soakrunner.h"
+#include "linksoak.h"
+#include "captureindex.h"
+#include "trace.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <cstdio>
+#include <optional>
+
+// Marks raw input ahead of widget handling; only installed while tracing.
+class TraceInputFilter : public QObject {
+public:
+    using QObject::QObject;
+protected:
+    bool eventFilter(QObject *obj, QEvent *e) override {
+        if (e->type() == QEvent::MouseButtonPress) trace::instant("input.mousePress");
+        else if (e->type() == QEvent::MouseButtonRelease) trace::instant("input.mouseRelease");
+        return QObject::eventFilter(obj, e);
+    }
+};
+
 int main(int argc, char *argv[]) {
     QApplication a(argc, argv);
+
+    // SIMPLEPTZ_TRACE=<file.json> records the command pipeline for Perfetto
+    const QByteArray tracePath = qgetenv("SIMPLEPTZ_TRACE");
+    if (!tracePath.isEmpty()) {
+        trace::setEnabled(true);
+        a.installEventFilter(new TraceInputFilter(&a));
+    }
+
+    // --soak <seconds> runs the load harness against a simulated camera
+    QCommandLineParser cli;
+    cli.addHelpOption();
+    cli.addOptions({
+        {"soak", "Soak run against a simulated camera for <seconds>.", "seconds"},
+        {"soak-rate", "Operator input events per second (default 20).", "hz"},
+        {"soak-poll", "Position inquiries per second (default 10).", "hz"},
+        {"soak-errors", "Fraction of frames the camera rejects (default 0).", "rate"},
+        {"soak-low-latency", "Apply the low-latency serial settings to the simulator's pty."},
+        {"soak-links", "Soak the multi-link engine with <n> simulated cameras instead of the window.", "n"},
+        {"soak-reactors", "Reactor threads for --soak-links (default one per core).", "n"},
+        {"soak-min-fps", "Fail below this many frames written per second.", "fps"},
+        {"soak-max-p99", "Fail above this p99 reply latency.", "ms"},
+        {"soak-max-failures", "Fail above this many unexplained errors (default 0).", "count"},
+        {"soak-max-rss-growth", "Fail when resident memory grows more than this after warm-up.", "kB"},
+        {"soak-report", "Also write the report as JSON.", "file"},
+        {"search", "Print the entries of the given session logs that match <query> and exit.", "query"},
+    });
+    cli.addPositionalArgument("logs", "Session log files for --search.", "[logs...]");
+    cli.process(a);
+
+    // --search <query> <logs...>: the search window's index, from a shell
+    if (cli.isSet("search")) {
+        QElapsedTimer t;
+        t.start();
+        CaptureIndex index;
+        CaptureIndex::Query q;
+        QString error;
+        const QStringList logs = cli.positionalArguments();
+        if (logs.isEmpty())
+            error = "no log files given";
+        else if (index.load(logs, &error))
+            index.parse(cli.value("search"), q, &error);
+        if (!error.isEmpty()) {
+            std::fprintf(stderr, "search: %s\n", qPrintable(error));
+            return 2;
+        }
+        const qint64 loadMs = t.restart();
+        std::size_t total = 0;
+        const std::vector<quint32> hits = index.find(q, std::size_t(-1), &total);
+        const qint64 queryMs = t.elapsed();
+        for (quint32 i : hits) std::printf("%s\n", qPrintable(index.format(i)));
+        std::fprintf(stderr, "%zu of %zu entries match (indexed in %lld ms, query %lld ms)\n",
+                     total, index.size(), loadMs, queryMs);
+        return total ? 0 : 1;
+    }
+
+    // A soak run must not touch the user's profiles, logs or the shared
+    // state a running instance publishes; all of it is settled before
+    // MainWindow reads its settings
+    std::optional<QTemporaryDir> soakSettings;
+    if (cli.isSet("soak")) {
+        QStandardPaths::setTestModeEnabled(true);
+        soakSettings.emplace();
+        QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, soakSettings->path());
+        QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, soakSettings->path());
+        QSettings seed("", "SimplePTZ");
+        const QString profile = QString("soak-%1").arg(QCoreApplication::applicationPid());
+        seed.setValue("profiles/list", QStringList{profile});
+        seed.setValue("profiles/current", profile);
+        seed.setValue("sessionLog/enabled", false);
+        seed.setValue("sharedState/enabled", false);
+    }
+
+    SoakRunner::Options o;
+    if (cli.isSet("soak")) {
+        auto number = [&](const char *name, double fallback) {
+            return cli.isSet(name) ? cli.value(name).toDouble() : fallback;
+        };
+        o.seconds     = int(number("soak", o.seconds));
+        o.actionsHz   = int(number("soak-rate", o.actionsHz));
+        o.pollHz      = int(number("soak-poll", o.pollHz));
+        o.errorRate   = number("soak-errors", o.errorRate);
+        o.lowLatency  = cli.isSet("soak-low-latency");
+        o.links       = int(number("soak-links", o.links));
+        o.reactors    = int(number("soak-reactors", o.reactors));
+        o.minFps      = number("soak-min-fps", o.minFps);
+        o.maxP99Ms    = number("soak-max-p99", o.maxP99Ms);
+        o.maxFailures = qint64(number("soak-max-failures", double(o.maxFailures)));
+        o.maxRssKb    = qint64(number("soak-max-rss-growth", double(o.maxRssKb)));
+        o.reportPath  = cli.value("soak-report");
+    }
+
+    // The multi-link soak exercises LinkEngine alone; no window needed
+    if (cli.isSet("soak") && o.links > 0) {
+        LinkSoak soak(o);
+        QTimer::singleShot(0, &soak, &LinkSoak::start);
+        return a.exec();
+    }
+
     MainWindow w;
     w.show();
-    return a.exec();
+
+    if (cli.isSet("soak")) {
+        auto *runner = new SoakRunner(w, o, &a);
+        QTimer::singleShot(0, runner, &SoakRunner::start);
+    }
+    const int rc = a.exec();
+
+    if (!tracePath.isEmpty() && !trace::exportChromeJson(tracePath.constData()))
+        qWarning("Failed to write trace to %s", tracePath.constData());
+    return rc;
 }
@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 
 #include <algorithm>
+#include <cmath>
 #include <QLabel>
 #include <QSpinBox>
 #include <QListWidget>
@@ -21,13 +22,41 @@
 #include <QCursor>
 #include <QCloseEvent>
 #include <QTextOption>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
 #include <QResizeEvent>
 #include <QDebug>
 #include <QTimer>
+#include <QShortcut>
+#include <QKeySequence>
+#include <QStandardPaths>
+#include <QFileInfo>
+
+#include "grouprecall.h"
+#include "capturesearch.h"
+#include "motionplanner.h"
+#include "trace.h"
 
 static const char* KEY_PROFILES_LIST   = "profiles/list";
 static const char* KEY_PROFILES_CURR   = "profiles/current";
 
+// Inquiries sent on connect. They are pipelined (CameraModel::inquiryWindow
+// at a time) so everything is answered in roughly one round-trip window.
+// Version goes early so later entries can be skipped for models that would
+// answer them with a syntax error.
+static const visca::Inquiry SNAPSHOT_PLAN[] = {
+    visca::Inquiry::Power, visca::Inquiry::Version, visca::Inquiry::ZoomPos,
+    visca::Inquiry::FocusMode, visca::Inquiry::PanTiltPos, visca::Inquiry::AeMode,
+};
+static const int SNAPSHOT_TIMEOUT_MS = 1500;
+static const int ESTIMATE_TICK_MS = 100;
+static const int MIN_CORRECTION_MS = 250;   // between corrective inquiries of one kind
+static const int RX_LOG_LINES = 5000;
+static const int BOOT_POLL_FIRST_MS = 250;   // power inquiry backoff while a camera boots
+static const int BOOT_POLL_MAX_MS   = 1000;
+static const int BOOT_GIVE_UP_MIN_MS = 15000;
+static const std::size_t BOOT_QUEUE_MAX = 32;
+
 static int heightForTextLines(const QPlainTextEdit *w, int lines) {
     QFontMetrics fm(w->font());
     const auto m = w->contentsMargins();
@@ -47,11 +76,156 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(&serial, &QSerialPort::errorOccurred, this, &MainWindow::onSerialError);
     connect(&serial, &QSerialPort::readyRead,     this, &MainWindow::onSerialReadyRead);
+    connect(&serial, &QSerialPort::bytesWritten,  this, [this](qint64 n){
+        trace::instant("serial.bytesWritten");
+        latency.bytesWritten(n);
+        Metrics::set(metrics.txQueueBytes, serial.bytesToWrite());
+    });
+
+    bootTimer.setSingleShot(true);
+    bootTimer.setTimerType(Qt::PreciseTimer);   // polls expire when the next is due
+    connect(&bootTimer, &QTimer::timeout, this, &MainWindow::pollBoot);
+
+    snapshotTimer.setSingleShot(true);
+    connect(&snapshotTimer, &QTimer::timeout, this, [this]{
+        if (warmValidating) finishWarmStart(nullptr);
+        else finishSnapshot(true);
+    });
+
+    estimatorClock.start();
+    estimateTimer.setInterval(ESTIMATE_TICK_MS);
+    connect(&estimateTimer, &QTimer::timeout, this, &MainWindow::updateEstimate);
+
+    cam = new CameraClient([this](const visca::RawFrame &f) {
+        if (!serial.isOpen()) return false;
+        // The client pairs replies with what it sent, so its frames go out now
+        clientSending = true;
+        sendVisca(f);
+        clientSending = false;
+        return true;
+    }, this);
+    cam->setAddress(viscaAddress);
+
+    discovery = new CameraDiscovery(this);
+    connect(discovery, &CameraDiscovery::finished, this, &MainWindow::onDiscoveryFinished);
+    oscListener = new OscListener(this);
+    connect(oscListener, &OscListener::command, this, &MainWindow::onOscCommand);
+
+    planner = new MotionPlanner({
+        [this](const visca::RawFrame &f) { sendVisca(f); },
+        [this](visca::Inquiry q) { sendInquiry(q); },
+        [this] { sentFrames.expire(); return sentFrames.inquiries(); },
+    }, this);
+    connect(planner, &MotionPlanner::finished, this,
+            [this](bool completed, int ms, int panErr, int tiltErr, int zoomErr) {
+        if (completed)
+            logEvent(QString("--- Smooth move done in %1 ms, residual pan %2 tilt %3 zoom %4 ---")
+                         .arg(ms).arg(panErr).arg(tiltErr).arg(zoomErr));
+        else
+            logEvent("--- Smooth move aborted ---");
+    });
+
+    // Group recall shares our port when it is the one connected
+    groupRecall = new GroupRecall({
+        [this](const QString &port) { return serial.isOpen() && port == connectedPort; },
+        [this](const visca::RawFrame &f) { sendVisca(f); },
+    }, this);
+    connect(groupRecall, &GroupRecall::report, this, [this](const QString &line) {
+        logEvent(line);
+    });
+
+    startSessionLog();
+    startMetrics();
+    startOsc();
 
     setWindowTitle("SimplePTZ");
     resize(260, 650);
 }
 
+// Application-wide, not per profile: one log covers the whole show
+void MainWindow::startSessionLog()
+{
+    if (!settings.value("sessionLog/enabled", true).toBool()) return;
+    SessionLog::Options o;
+    o.dir = settings.value("sessionLog/dir",
+                           QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                               + "/logs").toString();
+    o.maxBytes      = settings.value("sessionLog/maxMB", 16).toLongLong() * 1024 * 1024;
+    o.rotateMinutes = settings.value("sessionLog/rotateMinutes", o.rotateMinutes).toInt();
+    o.compress      = settings.value("sessionLog/compress", o.compress).toBool();
+    o.keepFiles     = settings.value("sessionLog/keepFiles", o.keepFiles).toInt();
+    if (!sessionLog.start(o))
+        qWarning() << "Session log disabled: cannot create" << o.dir;
+}
+
+// Off unless metrics/port is set; binds to loopback unless told otherwise
+void MainWindow::startMetrics()
+{
+    const int port = settings.value("metrics/port", 0).toInt();
+    if (port <= 0 || port > 65535) return;
+    const QHostAddress address(settings.value("metrics/address", "127.0.0.1").toString());
+    if (!metricsServer.start(address, quint16(port)))
+        qWarning() << "Metrics endpoint disabled: cannot listen on" << address.toString() << port;
+}
+
+// Off unless osc/port is set; consoles on other machines need osc/address 0.0.0.0
+void MainWindow::startOsc()
+{
+    const int port = settings.value("osc/port", 0).toInt();
+    if (port <= 0 || port > 65535) return;
+    const QHostAddress address(settings.value("osc/address", "127.0.0.1").toString());
+    if (!oscListener->start(address, quint16(port)))
+        qWarning() << "OSC input disabled: cannot bind" << address.toString() << port;
+}
+
+// Straight into the same send paths as the buttons, so a cue reaches the
+// wire in this call; only messages for the connected camera's address
+void MainWindow::onOscCommand(const osc::Command &c, qint64 arrivedNs)
+{
+    if (!serial.isOpen() || c.camera != viscaAddress) return;
+    latency.markInputAt(arrivedNs);
+    switch (c.kind) {
+    case osc::Command::Recall:
+        sendRecallPreset(c.preset);
+        break;
+    case osc::Command::Store:
+        if (c.preset >= cameraModel->presetCount) break;
+        sendStorePreset(c.preset);
+        capturePresetPose(c.preset);
+        break;
+    case osc::Command::Drive:
+        sendDrive(c.pan, c.tilt);
+        break;
+    case osc::Command::Zoom:
+        if (c.zoom == 0) sendZoomStop();
+        else sendZoom(c.zoom > 0, int(std::lround(std::abs(c.zoom) * cameraModel->zoomSpeedMax)));
+        break;
+    case osc::Command::Stop:
+        sendPanTiltStop();
+        sendZoomStop();
+        break;
+    case osc::Command::Focus:
+        sendRefocus();
+        break;
+    case osc::Command::None:
+        break;
+    }
+}
+
+void MainWindow::openCaptureSearch()
+{
+    if (!searchDialog) {
+        const QString dir = sessionLog.isRunning()
+            ? sessionLog.directory()
+            : settings.value("sessionLog/dir", QStandardPaths::writableLocation(
+                                                   QStandardPaths::AppLocalDataLocation) + "/logs").toString();
+        searchDialog = new CaptureSearchDialog(dir, this);
+    }
+    searchDialog->show();
+    searchDialog->raise();
+    searchDialog->activateWindow();
+}
+
 void MainWindow::buildUi()
 {
     auto *central = new QWidget(this);
@@ -81,10 +255,13 @@ void MainWindow::buildUi()
     portCombo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
     portCombo->setMinimumContentsLength(6);
 
+    scanButton = new QPushButton("Scan", this);
+    scanButton->setToolTip("Look for VISCA cameras on every serial port");
     connectButton = new QPushButton("Connect", this);
 
     row1->addWidget(portLbl);
     row1->addWidget(portCombo, 1);
+    row1->addWidget(scanButton);
     row1->addWidget(connectButton);
     rootV->addLayout(row1);
 
@@ -98,6 +275,12 @@ void MainWindow::buildUi()
     row2->addWidget(powerButton);
     rootV->addLayout(row2);
 
+    // Row 2b: camera state from the connect-time snapshot
+    stateLabel = new QLabel(this);
+    stateLabel->setWordWrap(true);
+    stateLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    rootV->addWidget(stateLabel);
+
     // Row 3: "How many presets?" + spin
     auto *row3 = new QHBoxLayout();
     presetCountLabel = new QLabel("How many presets?", this);
@@ -107,9 +290,21 @@ void MainWindow::buildUi()
     presetCountSpin->setButtonSymbols(QAbstractSpinBox::UpDownArrows);
     presetCountSpin->setLayoutDirection(Qt::LeftToRight);
 
+    // Smooth recall: eased move to the stored preset pose over N seconds
+    smoothCheck = new QCheckBox("Smooth", this);
+    smoothCheck->setToolTip("Recall presets with an eased move instead of the camera's own jump");
+    smoothSecs = new QDoubleSpinBox(this);
+    smoothSecs->setRange(1.0, 30.0);
+    smoothSecs->setSingleStep(0.5);
+    smoothSecs->setDecimals(1);
+    smoothSecs->setSuffix(" s");
+    smoothSecs->setValue(3.0);
+
     row3->addWidget(presetCountLabel);
     row3->addWidget(presetCountSpin);
     row3->addStretch();
+    row3->addWidget(smoothCheck);
+    row3->addWidget(smoothSecs);
     rootV->addLayout(row3);
 
     // Preset list (narrower, content-sized height)
@@ -121,6 +316,23 @@ void MainWindow::buildUi()
     presetList->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     rootV->addWidget(presetList);
 
+    // Row: camera group + recall selected preset on the whole group
+    auto *groupRow = new QHBoxLayout();
+    groupCombo = new QComboBox(this);
+    groupCombo->setMinimumWidth(80);
+    groupCombo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    groupCombo->setMinimumContentsLength(6);
+    groupCombo->setToolTip("Camera group (port:address members)");
+    groupRecallBtn = new QPushButton("Recall", this);
+    groupRecallBtn->setToolTip("Recall the selected preset on every camera in the group");
+    groupManageBtn = new QPushButton("…", this);
+    groupManageBtn->setFixedWidth(28);
+    groupRow->addWidget(new QLabel("Group:", this));
+    groupRow->addWidget(groupCombo, 1);
+    groupRow->addWidget(groupRecallBtn);
+    groupRow->addWidget(groupManageBtn);
+    rootV->addLayout(groupRow);
+
     // ---- Controls block under the preset list ----
     auto *controlsV = new QVBoxLayout();
 
@@ -219,16 +431,9 @@ void MainWindow::buildUi()
 
     cmdExecButton = new QPushButton("Execute", this);
 
-    auto addCmd = [&](const QString &label, const QByteArray &hex){
-        cmdCombo->addItem(label);
-        cmdCombo->setItemData(cmdCombo->count()-1, hex, Qt::UserRole);
-    };
-
-    addCmd("Power Inquiry — report ON/OFF (81 09 04 00 FF)", QByteArray::fromHex("81090400FF"));
-    addCmd("Pan/Tilt Home — center position (81 01 06 04 FF)", QByteArray::fromHex("81010604FF"));
-    addCmd("AF One-Push — refocus (81 01 04 18 01 FF)", QByteArray::fromHex("8101041801FF"));
-    addCmd("Focus Auto ON (81 01 04 38 02 FF)", QByteArray::fromHex("8101043802FF"));
-    addCmd("Focus Auto OFF / Manual (81 01 04 38 03 FF)", QByteArray::fromHex("8101043803FF"));
+    // Item data is an index into visca::CUSTOM_COMMANDS (frames built at compile time)
+    for (std::size_t i = 0; i < visca::CUSTOM_COMMANDS.size(); ++i)
+        cmdCombo->addItem(QString::fromUtf8(visca::CUSTOM_COMMANDS[i].label), int(i));
 
     cmdRow->addWidget(cmdCombo, 1);
     cmdRow->addWidget(cmdExecButton);
@@ -251,6 +456,7 @@ void MainWindow::buildUi()
         rxView->setFont(mono);
     }
     rxView->setPlaceholderText("Responses will appear here (TX/RX)...");
+    rxView->setMaximumBlockCount(RX_LOG_LINES);   // long sessions must not grow without bound
     rxView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     rootV->addWidget(rxView);
 
@@ -292,8 +498,13 @@ void MainWindow::buildUi()
     connect(presetList, &QListWidget::customContextMenuRequested, this, &MainWindow::renamePresetRequested);
     connect(presetList, &QListWidget::itemChanged, this, &MainWindow::onPresetNameEdited);
 
+    // Groups
+    connect(groupRecallBtn, &QPushButton::clicked, this, &MainWindow::recallGroup);
+    connect(groupManageBtn, &QPushButton::clicked, this, &MainWindow::manageGroups);
+
     // Ports & connect
     connect(connectButton, &QPushButton::clicked, this, &MainWindow::connectOrDisconnect);
+    connect(scanButton, &QPushButton::clicked, this, &MainWindow::scanForCameras);
 
     // PTZ pressed/released
     auto hookPtz = [this](QPushButton *btn, int dx, int dy) {
@@ -324,6 +535,28 @@ void MainWindow::buildUi()
     // Execute custom command
     connect(cmdExecButton, &QPushButton::clicked, this, &MainWindow::execSelectedCommand);
 
+    // Latency probes: stamp raw presses/releases on the motion buttons
+    for (QPushButton *b : {btnUpLeft, btnUp, btnUpRight, btnLeft, btnRight, btnDownLeft,
+                           btnDown, btnDownRight, btnZoomIn, btnZoomOut})
+        b->installEventFilter(this);
+
+    // Debug overlay with the rolling latency distribution
+    latencyOverlay = new QLabel(rxView);
+    latencyOverlay->setStyleSheet("background: rgba(0,0,0,190); color: #e0e0e0; padding: 4px;");
+    {
+        QFont mono = latencyOverlay->font();
+        mono.setStyleHint(QFont::Monospace);
+        mono.setFamily("monospace");
+        latencyOverlay->setFont(mono);
+    }
+    latencyOverlay->hide();
+    latencyTimer.setInterval(250);
+    connect(&latencyTimer, &QTimer::timeout, this, &MainWindow::updateLatencyOverlay);
+    auto *f12 = new QShortcut(QKeySequence(Qt::Key_F12), this);
+    connect(f12, &QShortcut::activated, this, &MainWindow::toggleLatencyOverlay);
+    auto *find = new QShortcut(QKeySequence::Find, this);
+    connect(find, &QShortcut::activated, this, &MainWindow::openCaptureSearch);
+
     // Initial sizing behaviors
     updatePresetListHeight();
     rxView->setMinimumHeight(rxTwoLineMinHeight());
@@ -377,6 +610,8 @@ void MainWindow::saveCurrentProfileSettings()
     settings.setValue(base + "panSpeed",  panSpeed->value());
     settings.setValue(base + "tiltSpeed", tiltSpeed->value());
     settings.setValue(base + "zoomSpeed", zoomSpeed->value());
+    settings.setValue(base + "smoothRecall",  smoothCheck->isChecked());
+    settings.setValue(base + "smoothSeconds", smoothSecs->value());
 
     settings.setValue(base + "lastPort", portCombo->currentText());
 
@@ -403,10 +638,19 @@ void MainWindow::loadProfileSettings(const QString &profile)
         item->setFlags(item->flags() | Qt::ItemIsEditable);
         presetList->addItem(item);
     }
+    markUnsupportedPresets();
 
     panSpeed ->setValue(settings.value(base + "panSpeed",  12).toInt());
     tiltSpeed->setValue(settings.value(base + "tiltSpeed", 10).toInt());
     zoomSpeed->setValue(settings.value(base + "zoomSpeed", 3).toInt());
+    smoothCheck->setChecked(settings.value(base + "smoothRecall", false).toBool());
+    smoothSecs->setValue(settings.value(base + "smoothSeconds", 3.0).toDouble());
+
+    // Link parameters found by a scan; Sony's defaults otherwise
+    baudRate = settings.value(base + "baud", 9600).toInt();
+    viscaAddress = std::clamp(settings.value(base + "address", 1).toInt(), 1, 7);
+    lowLatency = settings.value(base + "lowLatency", false).toBool();
+    if (cam) cam->setAddress(viscaAddress);
 
     // Restore last port if present (after refreshPorts ran)
     QString last = settings.value(base + "lastPort").toString();
@@ -415,7 +659,12 @@ void MainWindow::loadProfileSettings(const QString &profile)
         if (idx >= 0) portCombo->setCurrentIndex(idx);
     }
 
+    refreshGroupCombo();
     updatePresetListHeight();
+
+    // Local consumers find our state under the profile name
+    if (settings.value("sharedState/enabled", true).toBool()) statePublisher.open(profile);
+    publishState();
 }
 
 void MainWindow::switchProfile(const QString &profile)
@@ -423,11 +672,11 @@ void MainWindow::switchProfile(const QString &profile)
     if (profile.isEmpty() || profile == currentProfile) return;
 
     if (serial.isOpen()) {
-        serial.close();
+        closeSerial();
         setConnectedUi(false);
         powerLabel->setText("Power: Unknown");
         powerButton->setText("Power On");
-        if (rxView) rxView->appendPlainText("--- Disconnected (profile switch) ---");
+        logEvent("--- Disconnected (profile switch) ---");
     }
 
     saveCurrentProfileSettings();
@@ -442,6 +691,14 @@ void MainWindow::manageProfiles()
     QAction *aNew = m.addAction("New…");
     QAction *aRen = m.addAction("Rename…");
     QAction *aDel = m.addAction("Delete…");
+    QAction *aLow = nullptr;
+    if (SerialTuning::supported()) {
+        m.addSeparator();
+        aLow = m.addAction("Low-latency serial");
+        aLow->setToolTip("Shorten the USB adapter's receive timer (FTDI etc.) on connect");
+        aLow->setCheckable(true);
+        aLow->setChecked(lowLatency);
+    }
     QAction *chosen = m.exec(QCursor::pos());
     if (chosen == aNew) {
         createProfile();
@@ -449,6 +706,8 @@ void MainWindow::manageProfiles()
         renameCurrentProfile();
     } else if (chosen == aDel) {
         deleteCurrentProfile();
+    } else if (chosen && chosen == aLow) {
+        setLowLatency(aLow->isChecked());
     }
 }
 
@@ -507,7 +766,9 @@ void MainWindow::renameCurrentProfile()
 
     const QString from = "profiles/" + oldName + "/";
     const QString to   = "profiles/" + newName + "/";
-    const QStringList keys = { "presetCount", "presetNames", "panSpeed", "tiltSpeed", "zoomSpeed", "lastPort" };
+    const QStringList keys = { "presetCount", "presetNames", "panSpeed", "tiltSpeed", "zoomSpeed", "lastPort", "groups",
+                               "presetPoses", "smoothRecall", "smoothSeconds", "baud", "address",
+                               "cameraIdentity", "lowLatency" };
     for (const QString &k : keys)
         settings.setValue(to + k, settings.value(from + k));
     settings.remove(from);
@@ -582,11 +843,11 @@ void MainWindow::refreshPorts()
 void MainWindow::connectOrDisconnect()
 {
     if (serial.isOpen()) {
-        serial.close();
+        closeSerial();
         setConnectedUi(false);
         powerLabel->setText("Power: Unknown");
         powerButton->setText("Power On");
-        if (rxView) rxView->appendPlainText("--- Disconnected ---");
+        logEvent("--- Disconnected ---");
         return;
     }
 
@@ -596,23 +857,201 @@ void MainWindow::connectOrDisconnect()
         return;
     }
 
+    // Group recall may be holding the port open from an earlier group move
+    groupRecall->closePorts();
+
     serial.setPortName(sel);
-    serial.setBaudRate(QSerialPort::Baud9600);
+    serial.setBaudRate(baudRate);
 
     if (!serial.open(QIODevice::ReadWrite)) {
         QMessageBox::critical(this, "Error", QString("Failed to open %1").arg(sel));
         return;
     }
 
+    connectedPort = sel;
+    rxBuf.clear();
+    sentFrames.clear();
+    statsAtConnect = linkStats;
+    Metrics::add(metrics.connects);
+    Metrics::set(metrics.connected, 1);
+    updateQueueGauges();
+    camState = CameraState{};
+    estimator.reset();
+    applyCameraModel(GENERIC_CAMERA);
+    publishState();
     setConnectedUi(true);
-    if (rxView) rxView->appendPlainText(QString("--- Connected %1 ---").arg(sel));
+    logEvent(QString("--- Connected %1 (%2 baud) ---").arg(sel).arg(baudRate));
+    if (lowLatency) applySerialTuning();
 
     // Persist last port for this profile
     settings.setValue("profiles/" + currentProfile + "/lastPort", sel);
     settings.sync();
 
-    // Query power on connect
-    viscaPowerInquiry();
+    // Start from what this camera looked like last time if we know; otherwise
+    // learn power, version, zoom, focus, position and AE in one pipelined burst
+    if (!warmStart()) startSnapshot();
+}
+
+void MainWindow::closeSerial()
+{
+    reportReplyLatency();
+    storeCalibration();
+    storeStateCache();
+    estimateTimer.stop();
+    serialTuning.restore();   // needs the descriptor, so before close()
+    serial.close();
+}
+
+// -------------------- Low-latency serial --------------------
+
+void MainWindow::setLowLatency(bool on)
+{
+    lowLatency = on;
+    settings.setValue("profiles/" + currentProfile + "/lowLatency", on);
+    if (!serial.isOpen()) return;
+    // Latency so far belongs to the old mode
+    reportReplyLatency();
+    statsAtConnect = linkStats;
+    if (on) {
+        applySerialTuning();
+    } else {
+        serialTuning.restore();
+        logEvent("--- Low-latency serial off ---");
+    }
+}
+
+void MainWindow::applySerialTuning()
+{
+    const SerialTuning::Report r = serialTuning.apply(serial, connectedPort);
+    logEvent(QString("--- Low-latency serial: %1 ---").arg(r.describe()));
+}
+
+void MainWindow::reportReplyLatency()
+{
+    // This connection's share of the link counters
+    LinkStats s;
+    for (std::size_t i = 0; i < LinkStats::BUCKETS; ++i)
+        s.latency[i] = linkStats.latency[i] - statsAtConnect.latency[i];
+    s.latencyCount = linkStats.latencyCount - statsAtConnect.latencyCount;
+    s.latencySumUs = linkStats.latencySumUs - statsAtConnect.latencySumUs;
+    if (s.latencyCount < 20) return;   // too few replies to say anything
+
+    const bool tuned = serialTuning.isApplied();
+    const double mean = double(s.latencySumUs) / double(s.latencyCount) / 1000.0;
+    const double p50 = s.latencyQuantileMs(0.5);
+
+    // Compare with the last session in the other mode on the same port
+    const QString key = "serialLatency/" + QFileInfo(connectedPort).fileName() + "/";
+    settings.setValue(key + (tuned ? "tunedMeanMs" : "plainMeanMs"), mean);
+    const double other = settings.value(key + (tuned ? "plainMeanMs" : "tunedMeanMs"), 0.0).toDouble();
+
+    QString line = QString("--- Reply latency (%1): p50 ≤%2 ms, mean %3 ms over %4 replies")
+                       .arg(tuned ? "low-latency" : "default")
+                       .arg(p50).arg(mean, 0, 'f', 2).arg(s.latencyCount);
+    if (other > 0) {
+        const double plain = tuned ? other : mean, fast = tuned ? mean : other;
+        line += QString("; %1 ms default vs %2 ms low-latency (%3 ms saved per reply)")
+                    .arg(plain, 0, 'f', 2).arg(fast, 0, 'f', 2).arg(plain - fast, 0, 'f', 2);
+    }
+    logEvent(line + " ---");
+}
+
+// -------------------- Camera discovery --------------------
+
+void MainWindow::scanForCameras()
+{
+    QStringList ports;
+    for (int i = 0; i < portCombo->count(); ++i)
+        if (!(serial.isOpen() && portCombo->itemText(i) == connectedPort))
+            ports << portCombo->itemText(i);
+    // Ports held by a group recall would fail to open; let the scan have them
+    groupRecall->closePorts();
+
+    scanButton->setEnabled(false);
+    scanButton->setText("Scanning...");
+    discovery->scan(ports);
+}
+
+static QString describeCamera(const DiscoveredCamera &c)
+{
+    const QString what = c.address
+        ? QString("%1 (%2:%3 rom %4), camera %5")
+              .arg(lookupCameraModel(c.version).name)
+              .arg(c.version.vendor, 4, 16, QLatin1Char('0'))
+              .arg(c.version.model, 4, 16, QLatin1Char('0'))
+              .arg(c.version.rom, 4, 16, QLatin1Char('0'))
+              .arg(c.address)
+        : QString("VISCA device (no version reply)");
+    return QString("%1 at %2, %3 baud").arg(what, c.port).arg(c.baud);
+}
+
+void MainWindow::onDiscoveryFinished(const QList<DiscoveredCamera> &cameras, int elapsedMs)
+{
+    scanButton->setEnabled(true);
+    scanButton->setText("Scan");
+
+    if (cameras.isEmpty()) {
+        logEvent(QString("--- No cameras found (%1 ms) ---").arg(elapsedMs));
+        return;
+    }
+    for (const DiscoveredCamera &c : cameras)
+        logEvent(QString("--- Found %1 ---").arg(describeCamera(c)));
+    logEvent(QString("--- Scan done in %1 ms ---").arg(elapsedMs));
+    if (serial.isOpen()) return;   // don't switch away from a live link
+
+    // Prefer the camera this profile was last used with, wherever it moved to
+    const QString want = settings.value("profiles/" + currentProfile + "/cameraIdentity").toString();
+    const DiscoveredCamera *best = nullptr;
+    int bestScore = 0;
+    for (const DiscoveredCamera &c : cameras) {
+        const int score = c.matchScore(want);
+        if (score > bestScore) { best = &c; bestScore = score; }
+    }
+    const DiscoveredCamera *match = best;
+    if (!best && cameras.size() == 1) best = &cameras.first();
+    // A like camera on another adapter may be a second, identical one: offer it
+    if (best && best->autoSelectable(want)) {
+        useDiscoveredCamera(*best);
+        return;
+    }
+    if (match)
+        logEvent(QString("--- %1 looks like this profile's camera but is on another adapter; choose it from the list ---")
+                     .arg(describeCamera(*match)));
+
+    QMenu menu(this);
+    for (const DiscoveredCamera &c : cameras)
+        menu.addAction(describeCamera(c) + (&c == match ? " (this profile's camera?)" : ""), this,
+                       [this, c] { useDiscoveredCamera(c); });
+    menu.exec(scanButton->mapToGlobal(QPoint(0, scanButton->height())));
+}
+
+void MainWindow::useDiscoveredCamera(const DiscoveredCamera &c)
+{
+    if (portCombo->findText(c.port) < 0) portCombo->addItem(c.port);
+    portCombo->setCurrentText(c.port);
+    baudRate = c.baud;
+    if (c.address) {
+        viscaAddress = c.address;
+        cam->setAddress(viscaAddress);
+    }
+
+    const QString base = "profiles/" + currentProfile + "/";
+    settings.setValue(base + "baud", baudRate);
+    settings.setValue(base + "address", viscaAddress);
+    settings.sync();
+    logEvent(QString("--- Using %1 ---").arg(describeCamera(c)));
+}
+
+void MainWindow::rememberCameraIdentity(const visca::Reply &r)
+{
+    if (currentProfile.isEmpty() || !serial.isOpen()) return;
+    DiscoveredCamera c;
+    c.port = connectedPort;
+    c.adapterSerial = CameraDiscovery::adapterSerial(connectedPort);
+    c.baud = baudRate;
+    c.address = r.address;
+    c.version = r.version;
+    settings.setValue("profiles/" + currentProfile + "/cameraIdentity", c.identity());
 }
 
 void MainWindow::setConnectedUi(bool connected)
@@ -627,23 +1066,40 @@ void MainWindow::setConnectedUi(bool connected)
     };
     for (auto *b : btns) b->setEnabled(e);
     if (cmdCombo) cmdCombo->setEnabled(e);
+    if (!connected) {
+        if (planner) planner->stop();
+        if (cam) cam->reset();
+        Metrics::set(metrics.connected, 0);
+        capturePreset = -1;
+        snapshotTimer.stop();
+        publishState();
+        snapshotNext = -1;
+        warmValidating = false;
+        cachedPanTilt = cachedZoom = false;
+        if (powerState == PowerState::Booting) setPowerUi(PowerState::Unknown);
+        if (stateLabel) stateLabel->clear();
+    }
 }
 
 void MainWindow::onSerialError(QSerialPort::SerialPortError err)
 {
     if (err == QSerialPort::NoError) return;
-    if (serial.isOpen()) serial.close();
+    if (serial.isOpen()) {
+        Metrics::add(metrics.linkErrors);
+        closeSerial();
+    }
     setConnectedUi(false);
     powerLabel->setText("Power: Unknown");
     powerButton->setText("Power On");
     qWarning() << "Serial error:" << err << serial.errorString();
     QMessageBox::warning(this, "Serial Error", serial.errorString());
     refreshPorts();
-    if (rxView) rxView->appendPlainText("--- Serial error, disconnected ---");
+    logEvent("--- Serial error, disconnected ---");
 }
 
 void MainWindow::onSerialReadyRead()
 {
+    PTZ_TRACE_SCOPE("readyRead");
     rxBuf += serial.readAll();
     processIncomingFrames();
 }
@@ -661,6 +1117,7 @@ void MainWindow::onPresetCountChanged(int count)
         item->setFlags(item->flags() | Qt::ItemIsEditable);
         presetList->addItem(item);
     }
+    markUnsupportedPresets();
     saveCurrentProfileSettings();
     updatePresetListHeight();
 }
@@ -688,6 +1145,7 @@ void MainWindow::populatePresets(int count)
         item->setFlags(item->flags() | Qt::ItemIsEditable);
         presetList->addItem(item);
     }
+    markUnsupportedPresets();
     const QString base = "profiles/" + currentProfile + "/";
     settings.setValue(base + "presetNames", names);
 }
@@ -701,7 +1159,8 @@ void MainWindow::onPresetDoubleClicked()
     if (auto *item = presetList->currentItem()) {
         Q_UNUSED(item);
         int row = presetList->currentRow(); // 0..N-1
-        sendRecallPreset(row);
+        if (!smoothCheck->isChecked() || !startSmoothRecall(row))
+            sendRecallPreset(row);
     }
 }
 
@@ -721,6 +1180,7 @@ void MainWindow::renamePresetRequested(const QPoint &pos)
                 return;
             }
             sendStorePreset(row);
+            capturePresetPose(row);
         }
     }
 }
@@ -735,30 +1195,490 @@ void MainWindow::onPresetNameEdited(QListWidgetItem *item)
     saveCurrentProfileSettings();
 }
 
+// -------------------- Camera Groups --------------------
+
+QVariantMap MainWindow::loadGroups() const
+{
+    return settings.value("profiles/" + currentProfile + "/groups").toMap();
+}
+
+void MainWindow::saveGroups(const QVariantMap &groups)
+{
+    settings.setValue("profiles/" + currentProfile + "/groups", groups);
+    settings.sync();
+}
+
+void MainWindow::refreshGroupCombo()
+{
+    if (!groupCombo) return;
+    const QString prev = groupCombo->currentText();
+    const QVariantMap groups = loadGroups();
+    groupCombo->clear();
+    groupCombo->addItems(groups.keys());
+    int idx = groupCombo->findText(prev);
+    if (idx >= 0) groupCombo->setCurrentIndex(idx);
+    groupRecallBtn->setEnabled(!groups.isEmpty());
+}
+
+void MainWindow::recallGroup()
+{
+    const QString name = groupCombo->currentText();
+    if (name.isEmpty()) return;
+    const int row = presetList->currentRow();
+    if (row < 0) {
+        QMessageBox::information(this, "No preset", "Select a preset to recall on the group.");
+        return;
+    }
+    const auto members = GroupRecall::parseMembers(loadGroups().value(name).toStringList());
+    groupRecall->recall(name, members, row, baudRate);
+}
+
+void MainWindow::manageGroups()
+{
+    QMenu m(this);
+    QAction *aNew  = m.addAction("New group…");
+    QAction *aEdit = m.addAction("Edit members…");
+    QAction *aDel  = m.addAction("Delete group…");
+    const bool has = !groupCombo->currentText().isEmpty();
+    aEdit->setEnabled(has);
+    aDel->setEnabled(has);
+    QAction *chosen = m.exec(QCursor::pos());
+    if (!chosen) return;
+
+    QVariantMap groups = loadGroups();
+    QString name = groupCombo->currentText();
+    const QString hint = "Members as port:address[@baud], comma separated (port:* = every camera on that port):";
+
+    if (chosen == aDel) {
+        if (QMessageBox::question(this, "Delete Group", QString("Delete group \"%1\"?").arg(name)) != QMessageBox::Yes)
+            return;
+        groups.remove(name);
+        saveGroups(groups);
+        refreshGroupCombo();
+        return;
+    }
+
+    bool ok = false;
+    if (chosen == aNew) {
+        name = QInputDialog::getText(this, "New Group", "Group name:", QLineEdit::Normal, "", &ok).trimmed();
+        if (!ok || name.isEmpty()) return;
+        if (groups.contains(name)) { QMessageBox::warning(this, "Exists", "Group already exists."); return; }
+    }
+
+    const QString current = GroupRecall::formatMembers(
+        GroupRecall::parseMembers(groups.value(name).toStringList())).join(", ");
+    const QString seed = current.isEmpty() && !portCombo->currentText().isEmpty()
+                             ? portCombo->currentText() + ":1" : current;
+    const QString text = QInputDialog::getText(this, "Group Members", hint, QLineEdit::Normal, seed, &ok);
+    if (!ok) return;
+    const auto members = GroupRecall::parseMembers(text.split(',', Qt::SkipEmptyParts));
+    if (members.isEmpty()) {
+        QMessageBox::warning(this, "Group", "No valid members (expected e.g. COM4:1, COM4:2, COM5:*).");
+        return;
+    }
+    groups.insert(name, GroupRecall::formatMembers(members));
+    saveGroups(groups);
+    refreshGroupCombo();
+    groupCombo->setCurrentText(name);
+}
+
 // -------------------- VISCA RX/TX + Parsing --------------------
 
 void MainWindow::processIncomingFrames()
 {
+    PTZ_TRACE_SCOPE("processIncomingFrames");
+    // Decode in place; frames are only copied if they end up in the log.
+    const auto *data = reinterpret_cast<const visca::Byte *>(rxBuf.constData());
+    const bool annotate = rxView && rxView->isVisible();
+    qsizetype start = 0;
     while (true) {
-        int end = rxBuf.indexOf(char(0xFF));
+        const qsizetype end = rxBuf.indexOf(char(0xFF), start);
         if (end < 0) break;
-        QByteArray frame = rxBuf.left(end + 1);
-        rxBuf.remove(0, end + 1);
-
-        QString note;
-
-        // Power inquiry reply: 90 50 02 FF (ON), 90 50 03 FF (OFF)
-        if (frame.size() >= 4 && quint8(frame[0]) == 0x90 && quint8(frame[1]) == 0x50) {
-            if (quint8(frame[2]) == 0x02) {
-                setPowerUi(PowerState::On);
-                note = "power=On";
-            } else if (quint8(frame[2]) == 0x03) {
-                setPowerUi(PowerState::Off);
-                note = "power=Off";
+        const visca::Byte *frame = data + start;
+        const std::size_t len = std::size_t(end - start + 1);
+
+        // Inquiry replies carry no socket: the frame they answer says what they hold
+        const visca::SentFrame answered = sentFrames.retire(frame, len);
+        const visca::Reply reply = visca::decode(frame, len, answered.inquiry);
+        metrics.rx(len, reply, linkStats.onRx(len, reply, answered));
+        sessionLog.rx(reinterpret_cast<const char *>(frame), qsizetype(len));
+        handleReply(reply);
+        groupRecall->onReply(connectedPort, reply);
+        cam->onReply(reply, answered);   // may resume a coroutine; keep last
+
+        appendRx(QByteArray::fromRawData(reinterpret_cast<const char *>(frame), qsizetype(len)),
+                 annotate ? describeReply(reply) : QString());
+        start = end + 1;
+    }
+    if (start > 0) rxBuf.remove(0, start);
+    updateQueueGauges();
+}
+
+void MainWindow::updateQueueGauges()
+{
+    Metrics::set(metrics.pendingInquiries, sentFrames.inquiries());
+    Metrics::set(metrics.unansweredFrames, sentFrames.size());
+    Metrics::set(metrics.txQueueBytes, serial.bytesToWrite());
+}
+
+void MainWindow::handleReply(const visca::Reply &r)
+{
+    // Before apply(): the cached version is what the reply is checked against
+    if (warmValidating) {
+        if (r.kind == visca::ReplyKind::InquiryReply && r.inquiry == visca::Inquiry::Version)
+            finishWarmStart(&r);
+        else if (r.kind == visca::ReplyKind::Error && r.socket == 0)
+            finishWarmStart(nullptr);
+    }
+    if (r.inquiry == visca::Inquiry::PanTiltPos) cachedPanTilt = false;
+    else if (r.inquiry == visca::Inquiry::ZoomPos) cachedZoom = false;
+
+    if (camState.apply(r)) {
+        if (r.inquiry == visca::Inquiry::Power) {
+            // Booting: some models report "on" before they take commands; a
+            // Version reply after that shows the command processor is up
+            if (powerState == PowerState::Booting) {
+                if (r.powerOn) sendInquiry(visca::Inquiry::Version);
+            } else {
+                setPowerUi(r.powerOn ? PowerState::On : PowerState::Off);
+                // A restored pose waits for power before it is polled
+                if (r.powerOn && !estimateTimer.isActive()) estimateTimer.start();
             }
+        } else if (r.inquiry == visca::Inquiry::Version) {
+            applyCameraModel(lookupCameraModel(r.version));
+            rememberCameraIdentity(r);
+            if (powerState == PowerState::Booting && camState.powerOn) finishBoot(true);
+        } else if (r.inquiry == visca::Inquiry::PanTiltPos) {
+            estimator.measuredPanTilt(r.pan, r.tilt, estimatorClock.elapsed());
+        } else if (r.inquiry == visca::Inquiry::ZoomPos) {
+            estimator.measuredZoom(r.zoom, estimatorClock.elapsed());
+        }
+        publishState();
+        if (r.inquiry == visca::Inquiry::PanTiltPos)
+            planner->onPanTilt(r.pan, r.tilt);
+        else if (r.inquiry == visca::Inquiry::ZoomPos)
+            planner->onZoom(r.zoom);
+        updateStateLabel();
+
+        // Store the pose once both halves of a captured preset are in
+        const bool zoomInq = cameraModel->features & FEAT_ZOOM_POS_INQ;
+        if (capturePreset >= 0 && (r.inquiry == visca::Inquiry::ZoomPos
+                                   || (!zoomInq && r.inquiry == visca::Inquiry::PanTiltPos))) {
+            const QString key = "profiles/" + currentProfile + "/presetPoses";
+            QStringList poses = settings.value(key).toStringList();
+            while (poses.size() <= capturePreset) poses << QString();
+            poses[capturePreset] = QString("%1,%2,%3").arg(camState.pan).arg(camState.tilt)
+                                       .arg(zoomInq ? camState.zoom : 0);
+            settings.setValue(key, poses);
+            capturePreset = -1;
         }
+    }
+    if (snapshotNext >= 0) pumpSnapshot();
+}
+
+// -------------------- Connect-time snapshot --------------------
+
+void MainWindow::startSnapshot()
+{
+    snapshotNext = 0;
+    snapshotClock.start();
+    snapshotTimer.start(SNAPSHOT_TIMEOUT_MS);
+    pumpSnapshot();
+}
 
-        appendRx(frame, note);
+void MainWindow::pumpSnapshot()
+{
+    const int planSize = int(std::size(SNAPSHOT_PLAN));
+    while (snapshotNext < planSize && sentFrames.inquiries() < cameraModel->inquiryWindow) {
+        const visca::Inquiry q = SNAPSHOT_PLAN[snapshotNext++];
+        if (supportsInquiry(*cameraModel, q)) sendInquiry(q);
+    }
+    if (snapshotNext >= planSize && sentFrames.inquiries() == 0)
+        finishSnapshot(false);
+}
+
+void MainWindow::finishSnapshot(bool timedOut)
+{
+    if (snapshotNext < 0) return;
+    snapshotTimer.stop();
+    const int unanswered = sentFrames.inquiries() + int(std::size(SNAPSHOT_PLAN)) - snapshotNext;
+    snapshotNext = -1;
+    if (timedOut) sentFrames.clear();
+    if (timedOut)
+        logEvent(QString("--- Snapshot timed out after %1 ms, %2 unanswered ---")
+                     .arg(snapshotClock.elapsed()).arg(unanswered));
+    else
+        logEvent(QString("--- Snapshot complete in %1 ms ---").arg(snapshotClock.elapsed()));
+    storeStateCache();
+}
+
+// -------------------- Warm start --------------------
+
+// Per adapter (USB serial number, else the device name) and daisy-chain
+// address; the cached Version tells whether it is still the same camera.
+QString MainWindow::stateCacheKey() const
+{
+    const QString adapter = CameraDiscovery::adapterSerial(connectedPort);
+    const QString id = adapter.isEmpty() ? QFileInfo(connectedPort).fileName() : adapter;
+    return QString("stateCache/%1-%2").arg(id).arg(viscaAddress);
+}
+
+void MainWindow::storeStateCache()
+{
+    if (!serial.isOpen() || warmValidating || !camState.versionKnown) return;
+    const CameraState::Packed p = camState.pack();
+    settings.setValue(stateCacheKey(), QByteArray(reinterpret_cast<const char *>(p.data()), qsizetype(p.size())));
+}
+
+bool MainWindow::warmStart()
+{
+    const QByteArray blob = settings.value(stateCacheKey()).toByteArray();
+    CameraState cached;
+    if (!CameraState::unpack(reinterpret_cast<const std::uint8_t *>(blob.constData()),
+                             std::size_t(blob.size()), cached)
+        || !cached.versionKnown)
+        return false;
+
+    // Usable at once: model limits and settings as we left them. Power may
+    // have changed while we were away and waits for its inquiry; the pose
+    // is shown but uncertain, so the estimator polls it once power is on.
+    camState = cached;
+    camState.powerKnown = false;
+    camState.powerOn = false;
+    applyCameraModel(lookupCameraModel(camState.version));
+    if (camState.panTiltKnown) {
+        estimator.restored(PoseEstimator::Pan, camState.pan);
+        estimator.restored(PoseEstimator::Tilt, camState.tilt);
+    }
+    if (camState.zoomKnown) estimator.restored(PoseEstimator::Zoom, camState.zoom);
+    cachedPanTilt = camState.panTiltKnown;
+    cachedZoom = camState.zoomKnown;
+    publishState();
+    updateStateLabel();
+
+    warmValidating = true;
+    snapshotClock.start();
+    snapshotTimer.start(SNAPSHOT_TIMEOUT_MS);
+    sendInquiry(visca::Inquiry::Version);
+    if (supportsInquiry(*cameraModel, visca::Inquiry::Power)) sendInquiry(visca::Inquiry::Power);
+    return true;
+}
+
+void MainWindow::finishWarmStart(const visca::Reply *r)
+{
+    warmValidating = false;
+    snapshotTimer.stop();
+    const visca::Version &v = camState.version;
+    if (r && r->version.vendor == v.vendor && r->version.model == v.model && r->version.rom == v.rom) {
+        logEvent(QString("--- Warm start: cached state confirmed in %1 ms, %2 inquiries skipped ---")
+                     .arg(snapshotClock.elapsed()).arg(int(std::size(SNAPSHOT_PLAN)) - 2));
+        return;
+    }
+
+    // Another camera, or none answering: forget the cache and ask for everything
+    logEvent(r ? "--- Warm start: different camera on this port, refreshing ---"
+               : "--- Warm start: not confirmed, refreshing ---");
+    if (!r) sentFrames.clear();
+    camState = CameraState{};
+    estimator.reset();
+    cachedPanTilt = cachedZoom = false;
+    setPowerUi(PowerState::Unknown);
+    applyCameraModel(GENERIC_CAMERA);
+    publishState();
+    updateStateLabel();
+    startSnapshot();
+}
+
+void MainWindow::applyCameraModel(const CameraModel &m)
+{
+    const bool changed = cameraModel != &m;
+    if (changed) storeCalibration();
+    cameraModel = &m;
+
+    estimator.setModel(m, viscaAddress);
+    const QString cal = QString("calibration/%1/").arg(QString::fromUtf8(m.name));
+    estimator.setScale(PoseEstimator::Pan,  settings.value(cal + "pan", 1.0).toDouble());
+    estimator.setScale(PoseEstimator::Tilt, settings.value(cal + "tilt", 1.0).toDouble());
+    estimator.setScale(PoseEstimator::Zoom, settings.value(cal + "zoom", 1.0).toDouble());
+
+    // Only offer what the camera accepts; out-of-range speeds cost a syntax error
+    panSpeed->setMaximum(m.panSpeedMax);
+    tiltSpeed->setMaximum(m.tiltSpeedMax);
+    zoomSpeed->setMaximum(m.zoomSpeedMax);
+    panSpeed->setTickInterval(std::max(1, (m.panSpeedMax - 1) / 4));
+    tiltSpeed->setTickInterval(std::max(1, (m.tiltSpeedMax - 1) / 4));
+    // Never shrink below the profile's count: that would drop saved preset names
+    presetCountSpin->setMaximum(std::max(m.presetCount, presetCountSpin->value()));
+    const int unsupported = markUnsupportedPresets();
+
+    if (changed) {
+        logEvent(QString("--- Model: %1 (pan ≤%2, tilt ≤%3, %4 presets) ---")
+                     .arg(QString::fromUtf8(m.name)).arg(m.panSpeedMax)
+                     .arg(m.tiltSpeedMax).arg(m.presetCount));
+        if (unsupported)
+            logEvent(QString("--- Presets %1–%2 disabled: the camera stores only %3 ---")
+                         .arg(m.presetCount).arg(m.presetCount + unsupported - 1).arg(m.presetCount));
+    }
+}
+
+// Rows past what the camera stores keep their names but are greyed out, so
+// a double-click on one isn't silently ignored. Returns how many.
+int MainWindow::markUnsupportedPresets()
+{
+    int n = 0;
+    for (int i = 0; i < presetList->count(); ++i) {
+        QListWidgetItem *item = presetList->item(i);
+        const bool ok = i < cameraModel->presetCount;
+        item->setFlags(ok ? item->flags() | Qt::ItemIsEnabled : item->flags() & ~Qt::ItemIsEnabled);
+        item->setToolTip(ok ? QString() : QString("%1 stores %2 presets")
+                                              .arg(QString::fromUtf8(cameraModel->name))
+                                              .arg(cameraModel->presetCount));
+        if (!ok) ++n;
+    }
+    return n;
+}
+
+// Speed scales learned by the estimator, kept per camera model
+void MainWindow::storeCalibration()
+{
+    const QString cal = QString("calibration/%1/").arg(QString::fromUtf8(cameraModel->name));
+    settings.setValue(cal + "pan",  estimator.scale(PoseEstimator::Pan));
+    settings.setValue(cal + "tilt", estimator.scale(PoseEstimator::Tilt));
+    settings.setValue(cal + "zoom", estimator.scale(PoseEstimator::Zoom));
+}
+
+void MainWindow::publishState()
+{
+    statePublisher.publish(camState, viscaAddress, serial.isOpen(),
+                           serial.isOpen() && estimator.estimated());
+}
+
+void MainWindow::updateEstimate()
+{
+    const qint64 now = estimatorClock.elapsed();
+    estimator.advance(now);
+    if (camState.panTiltKnown && estimator.known(PoseEstimator::Pan)) {
+        camState.pan  = estimator.value(PoseEstimator::Pan);
+        camState.tilt = estimator.value(PoseEstimator::Tilt);
+    }
+    if (camState.zoomKnown && estimator.known(PoseEstimator::Zoom))
+        camState.zoom = estimator.value(PoseEstimator::Zoom);
+    publishState();
+    updateStateLabel();
+
+    // Ask the camera only once the guess may be off by more than the
+    // tolerance; the planner and the snapshot do their own polling
+    const bool ptWanted = supportsInquiry(*cameraModel, visca::Inquiry::PanTiltPos)
+                          && (estimator.needsCorrection(PoseEstimator::Pan)
+                              || estimator.needsCorrection(PoseEstimator::Tilt));
+    const bool zoomWanted = supportsInquiry(*cameraModel, visca::Inquiry::ZoomPos)
+                            && estimator.needsCorrection(PoseEstimator::Zoom);
+    const bool quiet = !planner->isActive() && snapshotNext < 0 && camState.powerOn
+                       && sentFrames.inquiries() < cameraModel->inquiryWindow;
+    if (quiet && ptWanted && now - lastPanTiltCorrectionMs >= MIN_CORRECTION_MS) {
+        lastPanTiltCorrectionMs = now;
+        sendInquiry(visca::Inquiry::PanTiltPos);
+    }
+    if (quiet && zoomWanted && now - lastZoomCorrectionMs >= MIN_CORRECTION_MS) {
+        lastZoomCorrectionMs = now;
+        sendInquiry(visca::Inquiry::ZoomPos);
+    }
+    if (!estimator.active() && (!camState.powerOn || (!ptWanted && !zoomWanted))) estimateTimer.stop();
+}
+
+void MainWindow::updateStateLabel()
+{
+    if (!stateLabel) return;
+    QStringList parts;
+    if (camState.versionKnown)
+        parts << QString::fromUtf8(cameraModel->name);
+    // "≈" while the position is dead-reckoned rather than read back
+    const QString approx = serial.isOpen() && estimator.estimated() ? QString("≈") : QString();
+    // ... or still the cached value from the last session (see warmStart())
+    if (camState.zoomKnown)
+        parts << "Zoom " + (cachedZoom ? QString("≈") : approx)
+                     + QString("%1").arg(camState.zoom, 4, 16, QLatin1Char('0')).toUpper();
+    if (camState.focusMode != visca::FocusMode::Unknown)
+        parts << (camState.focusMode == visca::FocusMode::Auto ? "AF" : "MF");
+    if (camState.panTiltKnown)
+        parts << QString("P/T %1%2/%3").arg(cachedPanTilt ? QString("≈") : approx)
+                     .arg(camState.pan).arg(camState.tilt);
+    switch (camState.aeMode) {
+    case visca::AeMode::FullAuto: parts << "AE Auto";    break;
+    case visca::AeMode::Manual:   parts << "AE Manual";  break;
+    case visca::AeMode::Shutter:  parts << "AE Shutter"; break;
+    case visca::AeMode::Iris:     parts << "AE Iris";    break;
+    case visca::AeMode::Bright:   parts << "AE Bright";  break;
+    default: break;
+    }
+    stateLabel->setText(parts.join("  ·  "));
+}
+
+static const char *errorName(visca::ErrorKind e)
+{
+    switch (e) {
+    case visca::ErrorKind::MessageLength: return "message length";
+    case visca::ErrorKind::Syntax:        return "syntax";
+    case visca::ErrorKind::BufferFull:    return "buffer full";
+    case visca::ErrorKind::Cancelled:     return "cancelled";
+    case visca::ErrorKind::NoSocket:      return "no socket";
+    case visca::ErrorKind::NotExecutable: return "not executable";
+    default:                              return "unknown";
+    }
+}
+
+QString MainWindow::describeResult(const CommandResult &r)
+{
+    switch (r.status) {
+    case CommandStatus::Completed:    return "completed";
+    case CommandStatus::Error:        return QString("camera error (%1)").arg(errorName(r.error));
+    case CommandStatus::Timeout:      return "timed out";
+    case CommandStatus::Cancelled:    return "cancelled";
+    case CommandStatus::Disconnected: return "disconnected";
+    }
+    return QString();
+}
+
+QString MainWindow::describeReply(const visca::Reply &r)
+{
+    using visca::ReplyKind;
+    switch (r.kind) {
+    case ReplyKind::Ack:           return QString("ack socket=%1").arg(r.socket);
+    case ReplyKind::Completion:    return QString("completion socket=%1").arg(r.socket);
+    case ReplyKind::AddressSet:    return QString("address set, next=%1").arg(r.socket);
+    case ReplyKind::NetworkChange: return "network change";
+    case ReplyKind::IfClear:       return "IF_Clear";
+    case ReplyKind::Unknown:       return QString();
+    case ReplyKind::Error:
+        return QString("error=%1 socket=%2").arg(errorName(r.error)).arg(r.socket);
+    case ReplyKind::InquiryReply:
+        break;
+    }
+
+    auto hex4 = [](int v) { return QString("%1").arg(v & 0xFFFF, 4, 16, QLatin1Char('0')).toUpper(); };
+    switch (r.inquiry) {
+    case visca::Inquiry::Power:      return r.powerOn ? "power=On" : "power=Off";
+    case visca::Inquiry::ZoomPos:    return "zoom=" + hex4(r.zoom);
+    case visca::Inquiry::FocusPos:   return "focus=" + hex4(r.focus);
+    case visca::Inquiry::FocusMode:
+        return r.focusMode == visca::FocusMode::Auto ? "focus=Auto"
+             : (r.focusMode == visca::FocusMode::Manual ? "focus=Manual" : "focus=?");
+    case visca::Inquiry::AeMode:
+        switch (r.aeMode) {
+        case visca::AeMode::FullAuto: return "AE=Full Auto";
+        case visca::AeMode::Manual:   return "AE=Manual";
+        case visca::AeMode::Shutter:  return "AE=Shutter Priority";
+        case visca::AeMode::Iris:     return "AE=Iris Priority";
+        case visca::AeMode::Bright:   return "AE=Bright";
+        default:                      return "AE=?";
+        }
+    case visca::Inquiry::PanTiltPos: return QString("pan=%1 tilt=%2").arg(r.pan).arg(r.tilt);
+    case visca::Inquiry::Version:
+        return QString("vendor=%1 model=%2 rom=%3 sockets=%4")
+            .arg(hex4(r.version.vendor), hex4(r.version.model), hex4(r.version.rom))
+            .arg(r.version.sockets);
+    default:
+        return QString();
     }
 }
 
@@ -771,6 +1691,13 @@ QString MainWindow::toHexSpaced(const QByteArray &bytes)
     return s.trimmed();
 }
 
+// Event lines go to the on-screen log and the session log
+void MainWindow::logEvent(const QString &line)
+{
+    sessionLog.event(line);
+    if (rxView) rxView->appendPlainText(line);
+}
+
 void MainWindow::appendTx(const QByteArray &bytes)
 {
     if (!rxView) return;
@@ -786,29 +1713,55 @@ void MainWindow::appendRx(const QByteArray &bytes, const QString &note)
         rxView->appendPlainText("RX: " + toHexSpaced(bytes) + "    // " + note);
 }
 
-void MainWindow::sendVisca(const QByteArray &bytes)
+void MainWindow::sendVisca(const char *data, qsizetype size)
 {
     if (!serial.isOpen()) return;
-    appendTx(bytes);
-    serial.write(bytes);
-    serial.flush();
+    if (powerState == PowerState::Booting && !clientSending && holdDuringBoot(data, size)) return;
+    PTZ_TRACE_SCOPE("sendVisca");
+    latency.markEnqueue(size, serial.bytesToWrite());
+    {
+        PTZ_TRACE_SCOPE("serial.write");
+        serial.write(data, size);
+        serial.flush();
+    }
+    const std::uint64_t seq = sentFrames.push(reinterpret_cast<const visca::Byte *>(data), std::size_t(size),
+                                              visca::SentFrames::now(), replyTimeoutMs);
+    linkStats.onTx(std::size_t(size));
+    metrics.tx(std::size_t(size));
+    estimator.onSent(reinterpret_cast<const visca::Byte *>(data), std::size_t(size),
+                     estimatorClock.elapsed());
+    if (estimator.active() && !estimateTimer.isActive()) estimateTimer.start();
+    updateQueueGauges();
+    sessionLog.tx(data, size);
+    cam->onSent(data, size, seq);
+    // Log after the bytes are on their way so the text view never delays them
+    appendTx(QByteArray::fromRawData(data, size)); // no copy; only the log line allocates
 }
 
 // -------------------- Power --------------------
 
-void MainWindow::viscaPowerInquiry()
+void MainWindow::sendInquiry(visca::Inquiry q, int timeoutMs)
 {
-    sendVisca(QByteArray::fromHex("81090400FF")); // Inquiry: power
+    if (!serial.isOpen() || q == visca::Inquiry::None) return;
+    replyTimeoutMs = timeoutMs;
+    sendVisca(visca::INQUIRY_FRAMES[std::size_t(q)].withAddress(viscaAddress));
+    replyTimeoutMs = visca::SentFrames::REPLY_TIMEOUT_MS;
 }
 
-void MainWindow::viscaPowerOn()
+void MainWindow::viscaPowerInquiry()
 {
-    sendVisca(QByteArray::fromHex("8101040002FF")); // Power On
+    sendInquiry(visca::Inquiry::Power);
 }
 
-void MainWindow::viscaPowerOff()
+// Waits for the camera to finish switching, then asks what it actually did
+CameraClient::Job MainWindow::setPower(bool on)
 {
-    sendVisca(QByteArray::fromHex("8101040003FF")); // Power Off
+    const int timeout = cameraModel->replyTimeoutMs + (on ? cameraModel->bootMs : 0);
+    const CommandResult r = co_await (on ? cam->powerOn(timeout) : cam->powerOff(timeout));
+    if (r.status == CommandStatus::Disconnected) co_return;
+    if (!r)
+        logEvent(QString("--- Power %1 %2 ---").arg(on ? "on" : "off", describeResult(r)));
+    sendInquiry(visca::Inquiry::Power);
 }
 
 void MainWindow::setPowerUi(PowerState s)
@@ -823,12 +1776,129 @@ void MainWindow::setPowerUi(PowerState s)
         powerLabel->setText("Power: Off");
         powerButton->setText("Power On");
         break;
+    case PowerState::Booting:
+        powerLabel->setText("Power: Starting…");
+        powerButton->setText("Power Off");
+        break;
     case PowerState::Unknown:
     default:
         powerLabel->setText("Power: Unknown");
         powerButton->setText("Power On");
         break;
     }
+    if (s == PowerState::Booting) return;
+    bootTimer.stop();
+    if (!bootQueue.empty()) {
+        logEvent(QString("--- Dropped %1 commands held during power-on ---").arg(bootQueue.size()));
+        bootQueue.clear();
+    }
+}
+
+// -------------------- Power-on readiness --------------------
+
+// Cameras ignore or refuse commands for several seconds after power-on.
+// Until a Power "on" and then a Version reply come back, polled with
+// backoff, operator commands are held (see holdDuringBoot) and sent the
+// moment the camera is ready.
+void MainWindow::startBootWatch()
+{
+    camState.powerKnown = camState.powerOn = false;
+    estimator.reset();   // cameras re-home on boot
+    bootClock.start();
+    bootPollMs = BOOT_POLL_FIRST_MS;
+    setPowerUi(PowerState::Booting);
+    bootTimer.start(bootPollMs);
+}
+
+void MainWindow::pollBoot()
+{
+    if (bootClock.elapsed() >= std::max(2 * cameraModel->bootMs, BOOT_GIVE_UP_MIN_MS)) {
+        finishBoot(false);
+        return;
+    }
+    // A booting camera may swallow inquiries. Each poll is given up when the
+    // next one is due, so lost polls leave the window instead of filling it,
+    // and SentFrames::answer() doesn't pair a late reply with them.
+    bootPollMs = std::min(bootPollMs * 2, BOOT_POLL_MAX_MS);
+    sentFrames.expire();
+    if (sentFrames.inquiries() < cameraModel->inquiryWindow) sendInquiry(visca::Inquiry::Power, bootPollMs);
+    bootTimer.start(bootPollMs);
+}
+
+void MainWindow::finishBoot(bool confirmed)
+{
+    std::vector<visca::RawFrame> held;
+    held.swap(bootQueue);
+    setPowerUi(confirmed ? PowerState::On : PowerState::Unknown);
+    if (confirmed)
+        logEvent(QString("--- Camera ready %1 ms after power-on, %2 held commands sent ---")
+                     .arg(bootClock.elapsed()).arg(held.size()));
+    else
+        logEvent(QString("--- Camera not confirmed ready after %1 ms, sending %2 held commands anyway ---")
+                     .arg(bootClock.elapsed()).arg(held.size()));
+    for (const visca::RawFrame &f : held) sendVisca(f);
+    // Positions, zoom and focus are whatever the boot left them at
+    if (confirmed && snapshotNext < 0) startSnapshot();
+}
+
+enum BootSlot { BOOT_OTHER, BOOT_PAN_TILT, BOOT_ZOOM, BOOT_FOCUS, BOOT_RECALL };
+
+static BootSlot bootSlot(const visca::RawFrame &f)
+{
+    const visca::Byte cat = f.bytes[2], cmd = f.bytes[3];
+    if (cat == 0x06 && cmd >= 0x01 && cmd <= 0x04) return BOOT_PAN_TILT;   // drive, absolute, relative, home
+    if (cat == 0x04 && (cmd == 0x07 || cmd == 0x47)) return BOOT_ZOOM;
+    if (cat == 0x04 && (cmd == 0x08 || cmd == 0x48)) return BOOT_FOCUS;     // drive, direct
+    if (cat == 0x04 && cmd == 0x3F && f.bytes[4] == 0x02) return BOOT_RECALL;
+    return BOOT_OTHER;
+}
+
+static bool isStop(const visca::RawFrame &f)
+{
+    const visca::Byte cat = f.bytes[2], cmd = f.bytes[3];
+    if (cat == 0x06 && cmd == 0x01 && f.size >= 9)
+        return f.bytes[6] == visca::PAN_STOP && f.bytes[7] == visca::TILT_STOP;
+    return cat == 0x04 && cmd == 0x07 && f.bytes[4] == 0x00;
+}
+
+// Only the latest motion of each kind survives: a newer drive replaces a
+// held drive, a recall replaces held pan/tilt and zoom moves, and a stop
+// just removes what it would stop, as the camera is still anyway. Preset
+// stores, focus mode and one-push changes and other settings keep their
+// order.
+bool MainWindow::holdDuringBoot(const char *data, qsizetype size)
+{
+    const auto *b = reinterpret_cast<const visca::Byte *>(data);
+    if (size < 5 || b[1] != 0x01) return false;          // inquiries, cancels
+    if (b[2] == 0x04 && b[3] == 0x00) return false;      // power itself
+
+    visca::RawFrame f;
+    f.size = std::min<std::size_t>(std::size_t(size), visca::MAX_FRAME);
+    std::copy_n(b, f.size, f.bytes.begin());
+    const BootSlot slot = bootSlot(f);
+    if (slot != BOOT_OTHER) {
+        std::erase_if(bootQueue, [slot](const visca::RawFrame &q) {
+            const BootSlot s = bootSlot(q);
+            return s == slot || (slot == BOOT_RECALL && (s == BOOT_PAN_TILT || s == BOOT_ZOOM));
+        });
+    }
+    if (isStop(f)) return true;
+    if (bootQueue.size() == BOOT_QUEUE_MAX) {
+        // Moves replace their own kind, so only other commands fill it up:
+        // refuse another one rather than lose one the operator already gave
+        if (slot == BOOT_OTHER) {
+            logEvent(QString("--- Camera still starting, %1 commands held; not holding %2 ---")
+                         .arg(bootQueue.size()).arg(toHexSpaced(QByteArray(data, size))));
+            return true;
+        }
+        const auto oldest = std::find_if(bootQueue.begin(), bootQueue.end(),
+                                         [](const visca::RawFrame &q) { return bootSlot(q) == BOOT_OTHER; });
+        logEvent(QString("--- Camera still starting; dropped held %1 to hold a move ---")
+                     .arg(toHexSpaced(QByteArray(oldest->data(), qsizetype(oldest->size)))));
+        bootQueue.erase(oldest);
+    }
+    bootQueue.push_back(f);
+    return true;
 }
 
 void MainWindow::powerToggle()
@@ -840,12 +1910,12 @@ void MainWindow::powerToggle()
         if (QMessageBox::question(this, "Confirm Power Off",
                                   "Are you sure you want to turn the camera off?")
             == QMessageBox::Yes) {
-            viscaPowerOff();
+            setPower(false);
             setPowerUi(PowerState::Off);
         }
     } else {
-        viscaPowerOn();
-        setPowerUi(PowerState::On);
+        setPower(true);
+        startBootWatch();
     }
 }
 
@@ -853,117 +1923,159 @@ void MainWindow::powerToggle()
 
 void MainWindow::sendRecallPreset(int n)
 {
-    if (n < 0 || n > 15) return;
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x04));
-    cmd.append(char(0x3F));
-    cmd.append(char(0x02));  // recall
-    cmd.append(char(n));     // 0x00..0x0F
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    PTZ_TRACE_SCOPE("sendRecallPreset");
+    latency.markSlot();
+    planner->stop(); // manual control overrides a smooth move
+    if (n < 0) return;
+    if (n >= cameraModel->presetCount) {
+        logEvent(QString("--- Preset %1 not recalled: the camera stores %2 ---").arg(n).arg(cameraModel->presetCount));
+        return;
+    }
+    sendVisca(visca::PresetRecall::encode(viscaAddress, n));
 }
 
 void MainWindow::sendStorePreset(int n)
 {
-    if (n < 0 || n > 15) return;
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x04));
-    cmd.append(char(0x3F));
-    cmd.append(char(0x01));  // set
-    cmd.append(char(n));     // 0x00..0x0F
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    PTZ_TRACE_SCOPE("sendStorePreset");
+    if (n < 0) return;
+    if (n >= cameraModel->presetCount) {
+        logEvent(QString("--- Preset %1 not stored: the camera stores %2 ---").arg(n).arg(cameraModel->presetCount));
+        return;
+    }
+    sendVisca(visca::PresetStore::encode(viscaAddress, n));
 }
 
 void MainWindow::ptzPressed(int dx, int dy)
 {
+    PTZ_TRACE_SCOPE("ptzPressed");
+    latency.markSlot();
+    planner->stop(); // manual control overrides a smooth move
     if (!serial.isOpen()) return;
-    int pan  = std::clamp(panSpeed->value(),  1, 24);
-    int tilt = std::clamp(tiltSpeed->value(), 1, 20);
-
-    quint8 panDir  = (dx < 0) ? 0x01 : (dx > 0 ? 0x02 : 0x03); // 01 left, 02 right, 03 stop
-    quint8 tiltDir = (dy < 0) ? 0x01 : (dy > 0 ? 0x02 : 0x03); // 01 up, 02 down, 03 stop
-
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x06));
-    cmd.append(char(0x01));
-    cmd.append(char(pan));
-    cmd.append(char(tilt));
-    cmd.append(char(panDir));
-    cmd.append(char(tiltDir));
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    cam->preempt();  // ... and a running recall, so the drive gets a socket now
+    const int panDir  = (dx < 0) ? visca::PAN_LEFT : (dx > 0 ? visca::PAN_RIGHT : visca::PAN_STOP);
+    const int tiltDir = (dy < 0) ? visca::TILT_UP  : (dy > 0 ? visca::TILT_DOWN : visca::TILT_STOP);
+    // Clamp to the model; encode() additionally clamps to the VISCA ranges
+    sendVisca(visca::PanTiltDrive::encode(viscaAddress,
+                                          std::min(panSpeed->value(), cameraModel->panSpeedMax),
+                                          std::min(tiltSpeed->value(), cameraModel->tiltSpeedMax),
+                                          panDir, tiltDir));
 }
 
 void MainWindow::ptzReleased()
 {
+    PTZ_TRACE_SCOPE("ptzReleased");
+    latency.markSlot();
     if (!serial.isOpen()) return;
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x06));
-    cmd.append(char(0x01));
-    cmd.append(char(std::clamp(panSpeed->value(),  1, 24)));
-    cmd.append(char(std::clamp(tiltSpeed->value(), 1, 20)));
-    cmd.append(char(0x03)); // stop pan
-    cmd.append(char(0x03)); // stop tilt
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    sendVisca(visca::PanTiltDrive::encode(viscaAddress,
+                                          std::min(panSpeed->value(), cameraModel->panSpeedMax),
+                                          std::min(tiltSpeed->value(), cameraModel->tiltSpeedMax),
+                                          visca::PAN_STOP, visca::TILT_STOP));
 }
 
 void MainWindow::zoomInPressed()
 {
+    PTZ_TRACE_SCOPE("zoomInPressed");
+    latency.markSlot();
+    planner->stop(); // manual control overrides a smooth move
     if (!serial.isOpen()) return;
-    int p = std::clamp(zoomSpeed->value(), 0, 7);
-    quint8 op = 0x20 | p; // 2p
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x04));
-    cmd.append(char(0x07));
-    cmd.append(char(op));
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    cam->preempt();  // ... and a running recall, so the drive gets a socket now
+    sendVisca(visca::ZoomTele::encode(viscaAddress, std::min(zoomSpeed->value(), cameraModel->zoomSpeedMax)));
 }
 
 void MainWindow::zoomOutPressed()
 {
+    PTZ_TRACE_SCOPE("zoomOutPressed");
+    latency.markSlot();
+    planner->stop(); // manual control overrides a smooth move
     if (!serial.isOpen()) return;
-    int p = std::clamp(zoomSpeed->value(), 0, 7);
-    quint8 op = 0x30 | p; // 3p
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x04));
-    cmd.append(char(0x07));
-    cmd.append(char(op));
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    cam->preempt();  // ... and a running recall, so the drive gets a socket now
+    sendVisca(visca::ZoomWide::encode(viscaAddress, std::min(zoomSpeed->value(), cameraModel->zoomSpeedMax)));
 }
 
 void MainWindow::zoomReleased()
 {
+    PTZ_TRACE_SCOPE("zoomReleased");
+    latency.markSlot();
     if (!serial.isOpen()) return;
-    QByteArray cmd;
-    cmd.append(char(0x81));
-    cmd.append(char(0x01));
-    cmd.append(char(0x04));
-    cmd.append(char(0x07));
-    cmd.append(char(0x00)); // stop
-    cmd.append(char(0xFF));
-    sendVisca(cmd);
+    sendVisca(visca::ZoomStop::encode(viscaAddress));
+}
+
+// Proportional versions of the pad and zoom buttons for OSC faders and
+// joysticks; any non-zero deflection moves at least at speed 1
+void MainWindow::sendDrive(double pan, double tilt)
+{
+    PTZ_TRACE_SCOPE("sendDrive");
+    latency.markSlot();
+    planner->stop(); // manual control overrides a smooth move
+    if (!serial.isOpen()) return;
+    if (pan == 0 && tilt == 0) {
+        sendPanTiltStop();
+        return;
+    }
+    cam->preempt();  // ... and a running recall, so the drive gets a socket now
+    const int panDir  = (pan < 0) ? visca::PAN_LEFT : (pan > 0 ? visca::PAN_RIGHT : visca::PAN_STOP);
+    const int tiltDir = (tilt > 0) ? visca::TILT_UP : (tilt < 0 ? visca::TILT_DOWN : visca::TILT_STOP);
+    sendVisca(visca::PanTiltDrive::encode(
+        viscaAddress,
+        std::max(1, int(std::lround(std::abs(pan) * cameraModel->panSpeedMax))),
+        std::max(1, int(std::lround(std::abs(tilt) * cameraModel->tiltSpeedMax))),
+        panDir, tiltDir));
+}
+
+void MainWindow::sendPanTiltStop()
+{
+    if (!serial.isOpen()) return;
+    sendVisca(visca::PanTiltDrive::encode(viscaAddress,
+                                          std::min(panSpeed->value(), cameraModel->panSpeedMax),
+                                          std::min(tiltSpeed->value(), cameraModel->tiltSpeedMax),
+                                          visca::PAN_STOP, visca::TILT_STOP));
+}
+
+void MainWindow::sendZoom(bool tele, int speed)
+{
+    PTZ_TRACE_SCOPE("sendZoom");
+    latency.markSlot();
+    planner->stop(); // manual control overrides a smooth move
+    if (!serial.isOpen()) return;
+    cam->preempt();
+    speed = std::clamp(speed, 0, cameraModel->zoomSpeedMax);
+    if (tele) sendVisca(visca::ZoomTele::encode(viscaAddress, speed));
+    else sendVisca(visca::ZoomWide::encode(viscaAddress, speed));
+}
+
+void MainWindow::sendZoomStop()
+{
+    if (!serial.isOpen()) return;
+    sendVisca(visca::ZoomStop::encode(viscaAddress));
 }
 
 void MainWindow::sendRefocus()
 {
     if (!serial.isOpen()) return;
-    sendVisca(QByteArray::fromHex("8101041801FF")); // AF one-push
+    sendVisca(visca::FocusOnePush::encode(viscaAddress));
+}
+
+void MainWindow::capturePresetPose(int n)
+{
+    if (!(cameraModel->features & FEAT_PAN_TILT_POS_INQ)) return;
+    capturePreset = n;
+    sendInquiry(visca::Inquiry::PanTiltPos);
+    if (cameraModel->features & FEAT_ZOOM_POS_INQ) sendInquiry(visca::Inquiry::ZoomPos);
+}
+
+bool MainWindow::startSmoothRecall(int n)
+{
+    if (!(cameraModel->features & FEAT_PAN_TILT_POS_INQ)) return false;
+    const QStringList poses = settings.value("profiles/" + currentProfile + "/presetPoses").toStringList();
+    const QStringList p = poses.value(n).split(',');
+    if (p.size() != 3) return false;   // stored before poses were captured: plain recall
+
+    MotionPlanner::Pose target;
+    target.pan  = p[0].toInt();
+    target.tilt = p[1].toInt();
+    target.zoom = p[2].toInt();
+    planner->start(*cameraModel, viscaAddress, target, int(smoothSecs->value() * 1000));
+    return true;
 }
 
 // -------------------- Custom Commands --------------------
@@ -976,9 +2088,10 @@ void MainWindow::execSelectedCommand()
     }
     int idx = cmdCombo->currentIndex();
     if (idx < 0) return;
-    QByteArray cmd = cmdCombo->itemData(idx, Qt::UserRole).toByteArray();
-    if (cmd.isEmpty()) return;
-    sendVisca(cmd);
+    const int entry = cmdCombo->itemData(idx, Qt::UserRole).toInt();
+    if (entry < 0 || entry >= int(visca::CUSTOM_COMMANDS.size())) return;
+    const visca::NamedCommand &c = visca::CUSTOM_COMMANDS[entry];
+    sendVisca(c.frame.withAddress(viscaAddress));
 }
 
 // -------------------- Events / sizing --------------------
@@ -986,6 +2099,7 @@ void MainWindow::execSelectedCommand()
 void MainWindow::closeEvent(QCloseEvent *e)
 {
     saveCurrentProfileSettings();
+    if (serial.isOpen()) closeSerial();   // put the adapter's latency timer back
     QMainWindow::closeEvent(e);
 }
 
@@ -996,6 +2110,52 @@ void MainWindow::resizeEvent(QResizeEvent *e)
     QMainWindow::resizeEvent(e);
 }
 
+bool MainWindow::eventFilter(QObject *obj, QEvent *e)
+{
+    if (e->type() == QEvent::MouseButtonPress || e->type() == QEvent::MouseButtonRelease)
+        latency.markInput();
+    return QMainWindow::eventFilter(obj, e);
+}
+
+// -------------------- Latency overlay --------------------
+
+void MainWindow::toggleLatencyOverlay()
+{
+    if (latencyOverlay->isVisible()) {
+        latencyTimer.stop();
+        latencyOverlay->hide();
+        return;
+    }
+    updateLatencyOverlay();
+    latencyOverlay->show();
+    latencyOverlay->raise();
+    latencyTimer.start();
+}
+
+void MainWindow::updateLatencyOverlay()
+{
+    static const char *names[LatencyProbe::SegmentCount] = {
+        "input→slot  ", "slot→enqueue", "enqueue→wire", "total       "
+    };
+    QString text = QString("latency, last %1 actions (ms)\n             p50   p95   p99   max")
+                       .arg(latency.samples());
+    for (int s = 0; s < LatencyProbe::SegmentCount; ++s) {
+        const auto sum = latency.summary(LatencyProbe::Segment(s));
+        text += QString("\n%1 %2 %3 %4 %5").arg(QString::fromUtf8(names[s]))
+                    .arg(sum.p50, 5, 'f', 2).arg(sum.p95, 5, 'f', 2)
+                    .arg(sum.p99, 5, 'f', 2).arg(sum.max, 5, 'f', 2);
+    }
+    const auto total = latency.summary(LatencyProbe::Total);
+    text += QString("\n<1:%1 <2:%2 <4:%3 <8:%4 <16:%5 ≥16:%6")
+                .arg(total.buckets[0]).arg(total.buckets[1]).arg(total.buckets[2])
+                .arg(total.buckets[3]).arg(total.buckets[4]).arg(total.buckets[5]);
+    text += total.overBudget ? QString("\nOVER 16 ms BUDGET: %1/%2").arg(total.overBudget).arg(total.count)
+                             : QString("\nwithin one frame (16 ms)");
+    latencyOverlay->setText(text);
+    latencyOverlay->adjustSize();
+    latencyOverlay->move(std::max(0, rxView->width() - latencyOverlay->width() - 4), 4);
+}
+
 // -------------------- Helpers for sizing --------------------
 
 int MainWindow::rxTwoLineMinHeight() const
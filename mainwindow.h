@@ -5,6 +5,25 @@
 #include <QSerialPort>
 #include <QSettings>
 #include <QListWidgetItem>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "visca.h"
+#include "viscareply.h"
+#include "latencyprobe.h"
+#include "linkstats.h"
+#include "camerastate.h"
+#include "cameramodels.h"
+#include "statepublisher.h"
+#include "cameraclient.h"
+#include "sessionlog.h"
+#include "cameradiscovery.h"
+#include "serialtuning.h"
+#include "metrics.h"
+#include "poseestimator.h"
+#include "osclistener.h"
+
+#include <vector>
 
 class QLabel;
 class QSpinBox;
@@ -13,10 +32,16 @@ class QPushButton;
 class QListWidget;
 class QSlider;
 class QPlainTextEdit;
+class QCheckBox;
+class QDoubleSpinBox;
+class GroupRecall;
+class CaptureSearchDialog;
+class MotionPlanner;
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
+    friend class SoakRunner;   // drives the slots and reads the link state
 public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override = default;
@@ -24,6 +49,7 @@ public:
 protected:
     void closeEvent(QCloseEvent *e) override;
     void resizeEvent(QResizeEvent *e) override;
+    bool eventFilter(QObject *obj, QEvent *e) override;
 
 private slots:
     // Profiles
@@ -33,6 +59,7 @@ private slots:
     // Ports / connection
     void refreshPorts();
     void connectOrDisconnect();
+    void scanForCameras();
     void onSerialError(QSerialPort::SerialPortError err);
     void onSerialReadyRead();
 
@@ -42,6 +69,10 @@ private slots:
     void renamePresetRequested(const QPoint &pos);
     void onPresetNameEdited(QListWidgetItem *item);
 
+    // Camera groups
+    void recallGroup();
+    void manageGroups();
+
     // PTZ / Zoom (press & release)
     void ptzPressed(int dx, int dy);
     void ptzReleased();
@@ -62,16 +93,25 @@ private:
 
     // UI: Ports
     QComboBox   *portCombo{};
+    QPushButton *scanButton{};
     QPushButton *connectButton{};
 
     // UI: Power
     QLabel      *powerLabel{};
     QPushButton *powerButton{};
+    QLabel      *stateLabel{};
 
     // UI: Presets
     QLabel      *presetCountLabel{};
     QSpinBox    *presetCountSpin{};
     QListWidget *presetList{};
+    QCheckBox      *smoothCheck{};
+    QDoubleSpinBox *smoothSecs{};
+
+    // UI: Camera groups
+    QComboBox   *groupCombo{};
+    QPushButton *groupRecallBtn{};
+    QPushButton *groupManageBtn{};
 
     // UI: PTZ pad
     QPushButton *btnUpLeft{};
@@ -101,14 +141,67 @@ private:
     QLabel *rxTitle{};
     QPlainTextEdit *rxView{};
 
+    // UI: Latency overlay (F12)
+    QLabel *latencyOverlay{};
+    QTimer  latencyTimer;
+
     // Core
     QSerialPort serial;
+    QString     connectedPort;
     QByteArray  rxBuf;
     QSettings   settings; // ("", "SimplePTZ")
+    int         viscaAddress{1}; // camera position on the daisy chain (1..7)
+    int         baudRate{9600};
+    bool        lowLatency{false};   // tune the adapter on connect, see serialtuning.h
+    SerialTuning serialTuning;
+    LinkStats    statsAtConnect;     // for this connection's reply latency
+    visca::SentFrames sentFrames;    // frames awaiting their first reply, see viscareply.h
+    GroupRecall *groupRecall{};
+    MotionPlanner *planner{};
+    CameraClient *cam{};             // awaitable commands, see cameraclient.h
+    int          capturePreset{-1};   // preset whose pose the next position replies belong to
+    LatencyProbe latency;
+    LinkStats    linkStats;
+    CameraState  camState;
+    const CameraModel *cameraModel{&GENERIC_CAMERA};
+    StatePublisher statePublisher;   // shared-memory copy of camState for local tools
+    SessionLog     sessionLog;       // TX/RX/events on disk, written off-thread
+    CaptureSearchDialog *searchDialog{};
+    Metrics        metrics;          // lock-free copy of the link counters for scraping
+    MetricsServer  metricsServer{metrics};
+    CameraDiscovery *discovery{};
+    OscListener    *oscListener{};   // show-control input, see osclistener.h
+
+    // Connect-time snapshot: index into the inquiry plan, -1 when idle
+    int           snapshotNext{-1};
+    QElapsedTimer snapshotClock;
+    QTimer        snapshotTimer;
+
+    // Warm start: camState restored from the cache on connect and confirmed
+    // by Version and Power inquiries instead of the snapshot, see warmStart()
+    bool          warmValidating{false};
+    bool          cachedPanTilt{false};   // shown from the cache until a position reply
+    bool          cachedZoom{false};
 
-    enum class PowerState { Unknown, On, Off };
+    // Dead-reckoned pose between position replies, see poseestimator.h
+    PoseEstimator estimator;
+    QElapsedTimer estimatorClock;
+    QTimer        estimateTimer;
+    qint64        lastPanTiltCorrectionMs{-1'000'000};
+    qint64        lastZoomCorrectionMs{-1'000'000};
+
+    enum class PowerState { Unknown, On, Off, Booting };
     PowerState powerState{PowerState::Unknown};
 
+    // Power-on readiness: commands issued while the camera boots wait in
+    // bootQueue until a Power and a Version reply show it is up
+    QTimer        bootTimer;
+    QElapsedTimer bootClock;
+    int           bootPollMs{0};
+    std::vector<visca::RawFrame> bootQueue;
+    bool          clientSending{false};   // frame comes from CameraClient, never held
+    int           replyTimeoutMs{visca::SentFrames::REPLY_TIMEOUT_MS};   // for the frame being sent
+
     // Profiles
     QString currentProfile;
     void buildUi();
@@ -122,32 +215,85 @@ private:
     // Preset helpers
     void savePresetState();
     void setConnectedUi(bool connected);
+    void closeSerial();
+    void startMetrics();
+    void startOsc();
+    void onOscCommand(const osc::Command &c, qint64 arrivedNs);
+    void openCaptureSearch();
+    void updateQueueGauges();
+    void setLowLatency(bool on);
+    void applySerialTuning();
+    void reportReplyLatency();
+    void onDiscoveryFinished(const QList<DiscoveredCamera> &cameras, int elapsedMs);
+    void useDiscoveredCamera(const DiscoveredCamera &c);
+    void rememberCameraIdentity(const visca::Reply &r);
     void populatePresets(int count);
     void ensurePresetNamesSize(const QString &profile, int count);
     void updatePresetListHeight();
+    int  markUnsupportedPresets();
     int  rxTwoLineMinHeight() const;
 
+    // Smooth recall: poses captured when a preset is stored
+    void capturePresetPose(int n);
+    bool startSmoothRecall(int n);
+
+    // Latency overlay
+    void toggleLatencyOverlay();
+    void updateLatencyOverlay();
+
+    // Group helpers
+    QVariantMap loadGroups() const;
+    void saveGroups(const QVariantMap &groups);
+    void refreshGroupCombo();
+
     // VISCA helpers
-    void sendVisca(const QByteArray &bytes);
+    void sendVisca(const char *data, qsizetype size);
+    template <std::size_t N>
+    void sendVisca(const visca::Frame<N> &f) { sendVisca(f.data(), qsizetype(N)); }
+    void sendVisca(const visca::RawFrame &f) { sendVisca(f.data(), qsizetype(f.size)); }
+    void startSessionLog();
+    void logEvent(const QString &line);
     void appendTx(const QByteArray &bytes);
     void appendRx(const QByteArray &bytes, const QString &note = QString());
     static QString toHexSpaced(const QByteArray &bytes);
+    static QString describeReply(const visca::Reply &r);
+    static QString describeResult(const CommandResult &r);
 
+    void sendInquiry(visca::Inquiry q, int timeoutMs = visca::SentFrames::REPLY_TIMEOUT_MS);
     void viscaPowerInquiry();
-    void viscaPowerOn();
-    void viscaPowerOff();
+    CameraClient::Job setPower(bool on);
     void setPowerUi(PowerState s);
+    void startBootWatch();
+    void pollBoot();
+    void finishBoot(bool confirmed);
+    bool holdDuringBoot(const char *data, qsizetype size);
+    void updateStateLabel();
+    void publishState();
+    void updateEstimate();
+    void storeCalibration();
+    void applyCameraModel(const CameraModel &m);
+
+    void startSnapshot();
+    void pumpSnapshot();
+    void finishSnapshot(bool timedOut);
+
+    QString stateCacheKey() const;
+    bool warmStart();
+    void finishWarmStart(const visca::Reply *version);   // nullptr: no usable reply
+    void storeStateCache();
 
     void sendRecallPreset(int n);         // n = 0..15
     void sendStorePreset(int n);          // n = 0..15
     void sendPanTilt(int dx, int dy);     // dx,dy ∈ {-1,0,1}
     void sendPanTiltStop();
+    void sendDrive(double pan, double tilt);   // -1..1 of the model's top speed, + = right/up
     void sendZoom(bool tele, int speed);  // tele=true zoom in; speed 0..7
     void sendZoomStop();
     void sendRefocus();
 
     // Parsing
     void processIncomingFrames();
+    void handleReply(const visca::Reply &r);
 };
 
 #endif // MAINWINDOW_H
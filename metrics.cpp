@@ -0,0 +1,147 @@
+#include "metrics.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+
+static const int MAX_REQUEST = 4096;   // a scrape's GET line and headers fit easily
+
+// -------------------- Exposition --------------------
+
+static std::uint64_t load(const Metrics::Counter &c) { return c.load(std::memory_order_relaxed); }
+static std::int64_t  load(const Metrics::Gauge &g)   { return g.load(std::memory_order_relaxed); }
+
+static void family(QByteArray &out, const char *name, const char *type, const char *help)
+{
+    out += QByteArray("# HELP ") + name + ' ' + help + '\n';
+    out += QByteArray("# TYPE ") + name + ' ' + type + '\n';
+}
+
+template <typename T>
+static void sample(QByteArray &out, const char *name, T value, const QByteArray &labels = {})
+{
+    out += name;
+    if (!labels.isEmpty()) out += '{' + labels + '}';
+    out += ' ' + QByteArray::number(value) + '\n';
+}
+
+QByteArray Metrics::exposition() const
+{
+    QByteArray out;
+    out.reserve(4096);
+
+    family(out, "simpleptz_frames_tx_total", "counter", "VISCA frames written.");
+    sample(out, "simpleptz_frames_tx_total", load(framesTx));
+    family(out, "simpleptz_frames_rx_total", "counter", "VISCA frames received.");
+    sample(out, "simpleptz_frames_rx_total", load(framesRx));
+    family(out, "simpleptz_bytes_tx_total", "counter", "Bytes written to the serial port.");
+    sample(out, "simpleptz_bytes_tx_total", load(bytesTx));
+    family(out, "simpleptz_bytes_rx_total", "counter", "Bytes of complete frames received.");
+    sample(out, "simpleptz_bytes_rx_total", load(bytesRx));
+    family(out, "simpleptz_rx_undecodable_total", "counter", "Received frames the parser rejected.");
+    sample(out, "simpleptz_rx_undecodable_total", load(undecodable));
+
+    static const char *KINDS[8] = {
+        nullptr, "message_length", "syntax", "buffer_full", "cancelled", "no_socket",
+        "not_executable", "other",
+    };
+    family(out, "simpleptz_error_replies_total", "counter", "VISCA error replies by kind.");
+    for (std::size_t i = 1; i < errorReplies.size(); ++i)
+        sample(out, "simpleptz_error_replies_total", load(errorReplies[i]),
+               QByteArray("kind=\"") + KINDS[i] + '"');
+
+    family(out, "simpleptz_connects_total", "counter", "Successful serial connects.");
+    sample(out, "simpleptz_connects_total", load(connects));
+    family(out, "simpleptz_link_errors_total", "counter", "Serial errors that dropped the link.");
+    sample(out, "simpleptz_link_errors_total", load(linkErrors));
+
+    family(out, "simpleptz_connected", "gauge", "1 while the serial link is open.");
+    sample(out, "simpleptz_connected", load(connected));
+    family(out, "simpleptz_pending_inquiries", "gauge", "Inquiries awaiting their reply.");
+    sample(out, "simpleptz_pending_inquiries", load(pendingInquiries));
+    family(out, "simpleptz_unanswered_frames", "gauge", "Frames written that have no ACK or reply yet.");
+    sample(out, "simpleptz_unanswered_frames", load(unansweredFrames));
+    family(out, "simpleptz_tx_queue_bytes", "gauge", "Bytes queued in the serial port, not yet written.");
+    sample(out, "simpleptz_tx_queue_bytes", load(txQueueBytes));
+
+    family(out, "simpleptz_reply_latency_seconds", "histogram",
+           "Time from writing a frame to its ACK, inquiry reply or error.");
+    std::uint64_t cumulative = 0;
+    for (std::size_t b = 0; b < LinkStats::BUCKET_US.size(); ++b) {
+        cumulative += load(latency[b]);
+        sample(out, "simpleptz_reply_latency_seconds_bucket", cumulative,
+               "le=\"" + QByteArray::number(double(LinkStats::BUCKET_US[b]) / 1e6) + '"');
+    }
+    cumulative += load(latency.back());
+    sample(out, "simpleptz_reply_latency_seconds_bucket", cumulative, "le=\"+Inf\"");
+    sample(out, "simpleptz_reply_latency_seconds_sum", double(load(latencySumUs)) / 1e6);
+    // Keep _count equal to the +Inf bucket even if a reply lands mid-scrape
+    sample(out, "simpleptz_reply_latency_seconds_count", cumulative);
+    return out;
+}
+
+// -------------------- HTTP endpoint --------------------
+
+MetricsServer::MetricsServer(const Metrics &m, QObject *parent)
+    : QObject(parent), metrics(m)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+bool MetricsServer::start(const QHostAddress &address, quint16 port)
+{
+    stop();
+    server = new QTcpServer;
+    server->moveToThread(&thread);
+    connect(server, &QTcpServer::newConnection, server, [this] { accept(); });
+    connect(&thread, &QThread::finished, server, &QObject::deleteLater);
+    thread.setObjectName("metrics");
+    thread.start();
+
+    bool ok = false;
+    QMetaObject::invokeMethod(server, [&] { ok = server->listen(address, port); },
+                              Qt::BlockingQueuedConnection);
+    if (!ok) stop();
+    return ok;
+}
+
+void MetricsServer::stop()
+{
+    if (!thread.isRunning()) return;
+    thread.quit();
+    thread.wait();   // `server` and its sockets are deleted on the way out
+    server = nullptr;
+}
+
+// Runs in `thread`. One request per connection, then close: scrapers
+// don't need keep-alive and it keeps this free of state.
+void MetricsServer::accept()
+{
+    while (QTcpSocket *s = server->nextPendingConnection()) {
+        connect(s, &QTcpSocket::disconnected, s, &QObject::deleteLater);
+        connect(s, &QTcpSocket::readyRead, s, [this, s] {
+            if (s->property("answered").toBool()) return;
+            const QByteArray seen = s->peek(MAX_REQUEST);
+            if (!seen.contains("\r\n\r\n") && seen.size() < MAX_REQUEST) return;
+            s->setProperty("answered", true);
+
+            const QList<QByteArray> line = seen.left(seen.indexOf("\r\n")).split(' ');
+            QByteArray status = "200 OK", body;
+            if (line.size() < 2 || line[0] != "GET") {
+                status = "405 Method Not Allowed";
+            } else if (line[1] == "/metrics") {
+                body = metrics.exposition();
+            } else {
+                status = "404 Not Found";
+            }
+            s->write("HTTP/1.1 " + status + "\r\n"
+                     "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                     "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                     "Connection: close\r\n\r\n" + body);
+            s->disconnectFromHost();
+        });
+    }
+}
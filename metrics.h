@@ -0,0 +1,91 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+// Link-health metrics in Prometheus text format.
+//
+// Metrics is a set of counters and gauges the GUI thread bumps next to
+// LinkStats on the sendVisca / processIncomingFrames paths; every update is
+// a single relaxed atomic add or store, so the hot path pays no lock and no
+// fence. MetricsServer answers GET /metrics from its own thread, so a
+// scrape never waits for (or delays) the GUI. Loads are relaxed too: a
+// scrape may see a histogram bucket a reply ahead of its _count, which
+// Prometheus tolerates.
+
+#include <QObject>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QThread>
+
+#include "linkstats.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+class QTcpServer;
+
+class Metrics
+{
+public:
+    using Counter = std::atomic<std::uint64_t>;
+    using Gauge   = std::atomic<std::int64_t>;
+
+    Counter framesTx{0}, framesRx{0};
+    Counter bytesTx{0}, bytesRx{0};
+    Counter undecodable{0};                          // frames the parser rejected
+    std::array<Counter, 8> errorReplies{};           // by LinkStats::errorIndex()
+    Counter connects{0};
+    Counter linkErrors{0};                           // serial errors that dropped the link
+    std::array<Counter, LinkStats::BUCKETS> latency{};
+    Counter latencySumUs{0};
+
+    Gauge connected{0};
+    Gauge pendingInquiries{0};
+    Gauge unansweredFrames{0};                       // written, no reply yet
+    Gauge txQueueBytes{0};                           // QSerialPort::bytesToWrite()
+
+    static void add(Counter &c, std::uint64_t n = 1) { c.fetch_add(n, std::memory_order_relaxed); }
+    static void set(Gauge &g, std::int64_t v) { g.store(v, std::memory_order_relaxed); }
+
+    void tx(std::size_t bytes)
+    {
+        add(framesTx);
+        add(bytesTx, bytes);
+    }
+
+    // `latencyUs` as returned by LinkStats::onRx
+    void rx(std::size_t bytes, const visca::Reply &r, std::int64_t latencyUs)
+    {
+        add(framesRx);
+        add(bytesRx, bytes);
+        if (r.kind == visca::ReplyKind::Unknown) add(undecodable);
+        else if (r.kind == visca::ReplyKind::Error) add(errorReplies[std::size_t(LinkStats::errorIndex(r.error))]);
+        if (latencyUs >= 0) {
+            add(latency[LinkStats::bucketOf(latencyUs)]);
+            add(latencySumUs, std::uint64_t(latencyUs));
+        }
+    }
+
+    QByteArray exposition() const;
+};
+
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MetricsServer(const Metrics &m, QObject *parent = nullptr);
+    ~MetricsServer() override;
+
+    bool start(const QHostAddress &address, quint16 port);
+    void stop();
+    bool isRunning() const { return thread.isRunning(); }
+
+private:
+    void accept();
+
+    const Metrics &metrics;
+    QThread thread;
+    QTcpServer *server = nullptr;   // lives in `thread`
+};
+
+#endif // METRICS_H
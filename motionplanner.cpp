@@ -0,0 +1,176 @@
+#include "motionplanner.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const int    TICK_MS = 100;
+static const double GAIN    = 2.0;   // 1/s: position error folded into velocity
+
+MotionPlanner::MotionPlanner(Link link, QObject *parent)
+    : QObject(parent), link(std::move(link))
+{
+    timer.setInterval(TICK_MS);
+    connect(&timer, &QTimer::timeout, this, &MotionPlanner::tick);
+}
+
+void MotionPlanner::start(const CameraModel &m, int addr, const Pose &target, int duration)
+{
+    if (isActive()) stop();
+    model = &m;
+    address = addr;
+    durationMs = std::max(duration, TICK_MS * 5);
+    pan  = Axis{};
+    tilt = Axis{};
+    zoom = Axis{};
+    pan.to  = std::clamp(target.pan,  m.panMin,  m.panMax);
+    tilt.to = std::clamp(target.tilt, m.tiltMin, m.tiltMax);
+    zoom.to = std::clamp(target.zoom, 0,         m.zoomMax);
+    lastPanCode = lastTiltCode = lastPanDir = lastTiltDir = 0;
+    lastZoomCmd = -1;
+    tickCount = 0;
+
+    gotPanTilt = false;
+    gotZoom = !(m.features & FEAT_ZOOM_POS_INQ);   // no zoom feedback: land only
+    phase = Phase::Measuring;
+    clock.start();
+    timer.start();
+    link.inquire(visca::Inquiry::PanTiltPos);
+    if (!gotZoom) link.inquire(visca::Inquiry::ZoomPos);
+}
+
+void MotionPlanner::onPanTilt(int p, int t)
+{
+    if (phase == Phase::Idle) return;
+    const qint64 now = clock.elapsed();
+    pan.measured = p;
+    tilt.measured = t;
+    pan.measuredAtMs = tilt.measuredAtMs = now;
+    gotPanTilt = true;
+    if (phase == Phase::Measuring && gotZoom) beginMove();
+}
+
+void MotionPlanner::onZoom(int z)
+{
+    if (phase == Phase::Idle) return;
+    zoom.measured = z;
+    zoom.measuredAtMs = clock.elapsed();
+    gotZoom = true;
+    if (phase == Phase::Measuring && gotPanTilt) beginMove();
+}
+
+void MotionPlanner::beginMove()
+{
+    pan.from = pan.measured;
+    tilt.from = tilt.measured;
+    zoom.from = zoom.measuredAtMs >= 0 ? zoom.measured : zoom.to;
+    moveStartMs = clock.elapsed();
+    phase = Phase::Moving;
+}
+
+int MotionPlanner::speedCode(double unitsPerSec, int rate, int maxCode)
+{
+    if (rate <= 0) return 0;
+    const int code = int(std::lround(std::abs(unitsPerSec) / rate * maxCode));
+    return std::clamp(code, 0, maxCode);
+}
+
+void MotionPlanner::tick()
+{
+    const qint64 now = clock.elapsed();
+    if (phase == Phase::Measuring) {
+        if (now > 2 * model->replyTimeoutMs) stop();   // camera never told us where it is
+        return;
+    }
+    if (phase != Phase::Moving) return;
+
+    const double u = std::clamp(double(now - moveStartMs) / durationMs, 0.0, 1.0);
+    if (u >= 1.0) {
+        land();
+        return;
+    }
+
+    // Minimum-jerk position and its time derivative
+    const double T  = durationMs / 1000.0;
+    const double s  = u * u * u * (10 - 15 * u + 6 * u * u);
+    const double ds = 30 * u * u * (1 - u) * (1 - u) / T;
+    auto velocity = [&](const Axis &a) {
+        const double desired = a.from + (a.to - a.from) * s;
+        double predicted = desired;
+        if (a.measuredAtMs >= 0)
+            predicted = a.measured + a.commanded * double(now - a.measuredAtMs) / 1000.0;
+        return (a.to - a.from) * ds + GAIN * (desired - predicted);
+    };
+
+    // Pan/tilt: one drive frame, only when the quantized command changes
+    const double pv = velocity(pan), tv = velocity(tilt);
+    const int pc = speedCode(pv, model->panRate,  model->panSpeedMax);
+    const int tc = speedCode(tv, model->tiltRate, model->tiltSpeedMax);
+    const int pd = pc == 0 ? visca::PAN_STOP  : (pv < 0 ? visca::PAN_LEFT : visca::PAN_RIGHT);
+    const int td = tc == 0 ? visca::TILT_STOP : (tv < 0 ? visca::TILT_DOWN : visca::TILT_UP);
+    if (pc != lastPanCode || tc != lastTiltCode || pd != lastPanDir || td != lastTiltDir) {
+        link.send(visca::PanTiltDrive::encode(address, std::max(pc, 1), std::max(tc, 1), pd, td));
+        lastPanCode = pc; lastTiltCode = tc; lastPanDir = pd; lastTiltDir = td;
+    }
+    pan.commanded  = (pv < 0 ? -1 : 1) * double(pc) * model->panRate  / model->panSpeedMax;
+    tilt.commanded = (tv < 0 ? -1 : 1) * double(tc) * model->tiltRate / model->tiltSpeedMax;
+
+    // Zoom: speeds 0..max are all moving, so code n maps to n+1 rate steps
+    if (zoom.measuredAtMs >= 0) {
+        const double zv = velocity(zoom);
+        const int steps = speedCode(zv, model->zoomRate, model->zoomSpeedMax + 1);
+        int cmd = 0;
+        if (steps > 0) cmd = (zv > 0 ? 0x20 : 0x30) | (steps - 1);
+        if (cmd != lastZoomCmd) {
+            if (cmd == 0)            link.send(visca::ZoomStop::encode(address));
+            else if (cmd & 0x10)     link.send(visca::ZoomWide::encode(address, cmd & 0x0F));
+            else                     link.send(visca::ZoomTele::encode(address, cmd & 0x0F));
+            lastZoomCmd = cmd;
+        }
+        zoom.commanded = (zv < 0 ? -1 : 1) * double(steps) * model->zoomRate / (model->zoomSpeedMax + 1);
+    }
+
+    // Feedback: alternate the two position inquiries, skipping a tick while
+    // the camera's inquiry window is full; the prediction covers the gap
+    if (link.pending() >= model->inquiryWindow) return;
+    const bool zoomTurn = (tickCount++ % 2) && (model->features & FEAT_ZOOM_POS_INQ);
+    link.inquire(zoomTurn ? visca::Inquiry::ZoomPos : visca::Inquiry::PanTiltPos);
+}
+
+void MotionPlanner::land()
+{
+    const qint64 now = clock.elapsed();
+    auto error = [&](const Axis &a) {
+        if (a.measuredAtMs < 0) return 0;
+        return int(std::lround(a.to - (a.measured + a.commanded * double(now - a.measuredAtMs) / 1000.0)));
+    };
+    const int pe = error(pan), te = error(tilt), ze = error(zoom);
+
+    // Absolute commands remove the residual error at a gentle speed
+    if (model->features & FEAT_ABSOLUTE_PT)
+        link.send(visca::PanTiltAbsolute::encode(address, std::max(1, model->panSpeedMax / 4),
+                                                 std::max(1, model->tiltSpeedMax / 4),
+                                                 int(pan.to), int(tilt.to)));
+    else
+        link.send(visca::PanTiltDrive::encode(address, 1, 1, visca::PAN_STOP, visca::TILT_STOP));
+    if (model->features & FEAT_ZOOM_DIRECT)
+        link.send(visca::ZoomDirect::encode(address, int(zoom.to)));
+    else if (lastZoomCmd > 0)
+        link.send(visca::ZoomStop::encode(address));
+
+    timer.stop();
+    phase = Phase::Idle;
+    emit finished(true, int(now - moveStartMs), pe, te, ze);
+}
+
+void MotionPlanner::stop()
+{
+    if (phase == Phase::Idle) return;
+    if (phase == Phase::Moving) {
+        link.send(visca::PanTiltDrive::encode(address, 1, 1, visca::PAN_STOP, visca::TILT_STOP));
+        if (lastZoomCmd > 0) link.send(visca::ZoomStop::encode(address));
+    }
+    timer.stop();
+    const int elapsed = phase == Phase::Moving ? int(clock.elapsed() - moveStartMs) : 0;
+    phase = Phase::Idle;
+    emit finished(false, elapsed, 0, 0, 0);
+}
@@ -0,0 +1,91 @@
+#ifndef MOTIONPLANNER_H
+#define MOTIONPLANNER_H
+
+// Smooth preset-to-preset moves.
+//
+// Instead of letting the camera jump to a preset at its own speed, the
+// planner measures the current pose, then follows a minimum-jerk path
+// (s = 10u^3 - 15u^4 + 6u^5, zero velocity and acceleration at both ends)
+// to the stored preset pose over a fixed duration. Every tick it streams
+// variable-speed Pan-tiltDrive / Zoom commands for the path velocity plus a
+// proportional correction from the latest position reply, and alternates
+// pan/tilt and zoom inquiries to close the loop. At the end it sends the
+// absolute position so the move lands exactly.
+//
+// Tick rate is chosen for 9600 baud: one drive (9 B), one zoom (6 B) and
+// one inquiry (5 B) per 100 ms tick is ~20 % of the link.
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <functional>
+
+#include "cameramodels.h"
+#include "visca.h"
+
+class MotionPlanner : public QObject
+{
+    Q_OBJECT
+public:
+    struct Pose { int pan = 0; int tilt = 0; int zoom = 0; };
+
+    // How the planner reaches the camera; both go through MainWindow so
+    // frames are logged and inquiries are paired with their replies.
+    // `pending` counts inquiries still waiting for a reply.
+    struct Link
+    {
+        std::function<void(const visca::RawFrame &)> send;
+        std::function<void(visca::Inquiry)>          inquire;
+        std::function<int()>                         pending;
+    };
+
+    explicit MotionPlanner(Link link, QObject *parent = nullptr);
+
+    // Measures the current pose, then moves to `target` in `durationMs`.
+    void start(const CameraModel &model, int address, const Pose &target, int durationMs);
+    // Halts any motion the planner started; no-op when idle.
+    void stop();
+    bool isActive() const { return phase != Phase::Idle; }
+
+    void onPanTilt(int pan, int tilt);
+    void onZoom(int zoom);
+
+signals:
+    // `panErr`/`tiltErr`: last measured distance from the target before landing
+    void finished(bool completed, int elapsedMs, int panErr, int tiltErr, int zoomErr);
+
+private slots:
+    void tick();
+
+private:
+    enum class Phase { Idle, Measuring, Moving };
+
+    struct Axis
+    {
+        double from = 0, to = 0;
+        double measured = 0;       // last reply
+        qint64 measuredAtMs = -1;
+        double commanded = 0;      // units/s currently commanded
+    };
+
+    void beginMove();
+    void land();
+    static int speedCode(double unitsPerSec, int rate, int maxCode);
+
+    Link   link;
+    QTimer timer;
+    QElapsedTimer clock;
+    Phase  phase = Phase::Idle;
+    const CameraModel *model = nullptr;
+    int    address = 1;
+    int    durationMs = 0;
+    qint64 moveStartMs = 0;
+    int    tickCount = 0;
+    bool   gotPanTilt = false, gotZoom = false;
+    Axis   pan, tilt, zoom;
+    int    lastPanCode = 0, lastTiltCode = 0, lastPanDir = 0, lastTiltDir = 0;
+    int    lastZoomCmd = -1;       // -1 none, 0 stop, else 0x2p / 0x3p
+};
+
+#endif // MOTIONPLANNER_H
@@ -0,0 +1,142 @@
+#include "osc.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace osc {
+
+// A NUL-terminated string padded to four bytes
+static bool paddedString(const std::uint8_t *p, std::size_t size, std::size_t &i, std::string_view &out)
+{
+    const void *nul = std::memchr(p + i, 0, size - i);
+    if (!nul) return false;
+    const std::size_t len = std::size_t(static_cast<const std::uint8_t *>(nul) - (p + i));
+    out = std::string_view(reinterpret_cast<const char *>(p + i), len);
+    i += (len + 4) & ~std::size_t(3);
+    return i <= size;
+}
+
+static std::uint64_t be64(const std::uint8_t *p)
+{
+    return std::uint64_t(be32(p)) << 32 | be32(p + 4);
+}
+
+bool decodeMessage(const std::uint8_t *p, std::size_t size, Message &out)
+{
+    if (size < 4 || size % 4 || p[0] != '/') return false;
+    std::size_t i = 0;
+    if (!paddedString(p, size, i, out.address)) return false;
+    if (i == size) return true;   // very old senders omit the type tags
+
+    std::string_view types;
+    if (!paddedString(p, size, i, types) || types.empty() || types[0] != ',') return false;
+    for (const char t : types.substr(1)) {
+        Arg a;
+        a.type = t;
+        switch (t) {
+        case 'i': case 'c': case 'r': case 'm':
+            if (size - i < 4) return false;
+            a.number = double(std::int32_t(be32(p + i)));
+            i += 4;
+            break;
+        case 'f':
+            if (size - i < 4) return false;
+            a.number = double(std::bit_cast<float>(be32(p + i)));
+            i += 4;
+            break;
+        case 'h': case 't':
+            if (size - i < 8) return false;
+            a.number = double(std::int64_t(be64(p + i)));
+            i += 8;
+            break;
+        case 'd':
+            if (size - i < 8) return false;
+            a.number = std::bit_cast<double>(be64(p + i));
+            i += 8;
+            break;
+        case 's': case 'S':
+            if (!paddedString(p, size, i, a.text)) return false;
+            break;
+        case 'b': {
+            if (size - i < 4) return false;
+            const std::size_t n = be32(p + i);
+            i += 4;
+            if (n > size - i) return false;
+            i += (n + 3) & ~std::size_t(3);
+            if (i > size) return false;
+            break;
+        }
+        case 'T': case 'F': case 'N': case 'I': break;
+        default:
+            return false;   // '[' arrays and unknown tags: can't tell the size
+        }
+        if (out.argCount < MAX_ARGS) out.args[out.argCount++] = a;
+    }
+    return true;
+}
+
+// Only the four OSC number types; nil, infinitum, T/F, chars, colours and
+// time tags aren't amounts
+static bool isNumber(const Arg &a)
+{
+    switch (a.type) {
+    case 'i': case 'f': case 'h': case 'd':
+        return std::isfinite(a.number);
+    default:
+        return false;
+    }
+}
+
+static double unit(double v)
+{
+    return std::clamp(v, -1.0, 1.0);
+}
+
+bool route(const Message &m, Command &out)
+{
+    std::string_view a = m.address;
+    if (!a.starts_with("/ptz/")) return false;
+    a.remove_prefix(5);
+
+    int camera = 0;
+    std::size_t digits = 0;
+    while (digits < a.size() && digits < 2 && a[digits] >= '0' && a[digits] <= '9')
+        camera = camera * 10 + (a[digits++] - '0');
+    if (!digits || digits == a.size() || a[digits] != '/') return false;
+    a.remove_prefix(digits + 1);
+
+    auto number = [&](std::size_t n, double &v) {
+        if (m.argCount <= n || !isNumber(m.args[n])) return false;
+        v = m.args[n].number;
+        return true;
+    };
+
+    Command c;
+    c.camera = camera;
+    double v = 0, w = 0;
+    if (a == "preset/recall" || a == "preset/store") {
+        if (!number(0, v) || v < 0 || v > 0x7F) return false;
+        c.kind = a == "preset/recall" ? Command::Recall : Command::Store;
+        c.preset = int(std::lround(v));
+    } else if (a == "drive") {
+        if (!number(0, v) || !number(1, w)) return false;
+        c.kind = Command::Drive;
+        c.pan = unit(v);
+        c.tilt = unit(w);
+    } else if (a == "zoom") {
+        if (!number(0, v)) return false;
+        c.kind = Command::Zoom;
+        c.zoom = unit(v);
+    } else if (a == "stop") {
+        c.kind = Command::Stop;
+    } else if (a == "focus/onepush") {
+        c.kind = Command::Focus;
+    } else {
+        return false;
+    }
+    out = c;
+    return true;
+}
+
+} // namespace osc
@@ -0,0 +1,89 @@
+#ifndef OSC_H
+#define OSC_H
+
+// Open Sound Control 1.0 decoding and the /ptz address space.
+//
+// decode() walks one UDP packet, a message or a (nested) bundle, and hands
+// each message to a callback. Messages point into the packet: the address
+// and string arguments are views and numbers are decoded in place, so
+// nothing is allocated or copied. Bundle time tags are ignored; everything
+// runs on arrival, which is what a show-control cue expects.
+//
+// route() maps a message onto a PTZ command:
+//   /ptz/<cam>/preset/recall n     preset as numbered in the list (0-based)
+//   /ptz/<cam>/preset/store n
+//   /ptz/<cam>/drive pan tilt      -1..1 of full speed, + = right/up; 0 0 stops
+//   /ptz/<cam>/zoom z              -1..1, + = tele; 0 stops
+//   /ptz/<cam>/stop                pan/tilt and zoom
+//   /ptz/<cam>/focus/onepush
+// <cam> is the camera's VISCA address. Numbers may come as i, f, h or d;
+// any other type in their place drops the message.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace osc {
+
+inline constexpr std::size_t MAX_ARGS  = 4;   // later arguments are skipped
+inline constexpr int         MAX_DEPTH = 4;   // bundles within bundles
+
+struct Arg
+{
+    char             type = 0;
+    double           number = 0;    // numeric arguments
+    std::string_view text;          // s and S arguments
+};
+
+struct Message
+{
+    std::string_view address;
+    std::array<Arg, MAX_ARGS> args{};
+    std::size_t argCount = 0;
+};
+
+struct Command
+{
+    enum Kind { None, Recall, Store, Drive, Zoom, Stop, Focus };
+    Kind   kind = None;
+    int    camera = 0;
+    int    preset = 0;
+    double pan = 0, tilt = 0, zoom = 0;
+};
+
+bool decodeMessage(const std::uint8_t *p, std::size_t size, Message &out);
+bool route(const Message &m, Command &out);
+
+inline std::uint32_t be32(const std::uint8_t *p)
+{
+    return std::uint32_t(p[0]) << 24 | std::uint32_t(p[1]) << 16 | std::uint32_t(p[2]) << 8 | p[3];
+}
+
+// Returns false for a malformed packet; messages ahead of the fault have
+// already been delivered.
+template <typename F>
+bool decode(const std::uint8_t *p, std::size_t size, F &&onMessage, int depth = 0)
+{
+    if (size >= 8 && std::memcmp(p, "#bundle", 8) == 0) {
+        if (depth >= MAX_DEPTH || size < 16) return false;
+        std::size_t i = 16;    // "#bundle\0" and the time tag
+        while (i < size) {
+            if (size - i < 4) return false;
+            const std::uint32_t n = be32(p + i);
+            i += 4;
+            if (n > size - i || n % 4) return false;
+            if (!decode(p + i, n, onMessage, depth + 1)) return false;
+            i += n;
+        }
+        return true;
+    }
+    Message m;
+    if (!decodeMessage(p, size, m)) return false;
+    onMessage(m);
+    return true;
+}
+
+} // namespace osc
+
+#endif // OSC_H
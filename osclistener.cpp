@@ -0,0 +1,53 @@
+#include "osclistener.h"
+
+#include <QUdpSocket>
+
+#include <chrono>
+
+OscListener::OscListener(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool OscListener::start(const QHostAddress &address, quint16 port)
+{
+    stop();
+    socket = new QUdpSocket(this);
+    if (!socket->bind(address, port)) {
+        delete socket;
+        socket = nullptr;
+        return false;
+    }
+    connect(socket, &QUdpSocket::readyRead, this, &OscListener::readPending);
+    return true;
+}
+
+void OscListener::stop()
+{
+    delete socket;
+    socket = nullptr;
+}
+
+void OscListener::readPending()
+{
+    while (socket && socket->hasPendingDatagrams()) {
+        const qint64 arrivedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        const qint64 pending = socket->pendingDatagramSize();
+        const qint64 n = socket->readDatagram(buf.data(), qint64(buf.size()));
+        if (n < 0) break;
+        ++count.packets;
+        if (pending > qint64(buf.size())) {   // truncated; decoding the rest would misread it
+            ++count.malformed;
+            continue;
+        }
+        const bool ok = osc::decode(reinterpret_cast<const std::uint8_t *>(buf.data()), std::size_t(n),
+                                    [&](const osc::Message &m) {
+            ++count.messages;
+            osc::Command c;
+            if (osc::route(m, c)) emit command(c, arrivedNs);
+            else ++count.unrouted;
+        });
+        if (!ok) ++count.malformed;
+    }
+}
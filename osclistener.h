@@ -0,0 +1,52 @@
+#ifndef OSCLISTENER_H
+#define OSCLISTENER_H
+
+// OSC over UDP for lighting and show-control consoles.
+//
+// Datagrams are read into a fixed buffer on the GUI thread, the same thread
+// that owns the serial port. Each one is decoded in place (osc.h) and every
+// routable message is emitted as command(), which MainWindow connects
+// directly to the existing send paths. A cue therefore goes from the socket
+// to QSerialPort::write in one call chain, with no queue or thread hop in
+// between. `arrivedNs` is the steady-clock time the datagram was taken off
+// the socket, so LatencyProbe measures packet-to-wire.
+
+#include <QObject>
+#include <QHostAddress>
+
+#include "osc.h"
+
+#include <array>
+
+class QUdpSocket;
+
+class OscListener : public QObject
+{
+    Q_OBJECT
+public:
+    struct Counters {
+        quint64 packets = 0;
+        quint64 messages = 0;
+        quint64 malformed = 0;      // undecodable or oversized datagrams
+        quint64 unrouted = 0;       // well-formed, but not a /ptz command we know
+    };
+
+    explicit OscListener(QObject *parent = nullptr);
+
+    bool start(const QHostAddress &address, quint16 port);
+    void stop();
+    bool isRunning() const { return socket != nullptr; }
+    const Counters &counters() const { return count; }
+
+signals:
+    void command(const osc::Command &c, qint64 arrivedNs);
+
+private:
+    void readPending();
+
+    QUdpSocket *socket = nullptr;
+    std::array<char, 4096> buf{};   // one Ethernet frame's worth, with room for bundles
+    Counters count;
+};
+
+#endif // OSCLISTENER_H
@@ -0,0 +1,196 @@
+#include "poseestimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const double RATE_ERROR     = 0.10;   // fraction of travel, before calibration settles
+static const double TIMING_MS      = 40.0;   // command latency + motor ramp per speed change
+static const double REPLY_LAG_MS   = 30.0;   // a reply describes the axis this long ago
+static const double LEARN_GAIN     = 0.3;
+static const double TOLERANCE_MS   = 100.0;  // pan/tilt: travel at full speed in this long
+static const double ZOOM_TOLERANCE = 0.01;   // fraction of the zoom range
+
+void PoseEstimator::setModel(const CameraModel &m, int addr)
+{
+    address = addr;
+    panSpeedMax = m.panSpeedMax;
+    tiltSpeedMax = m.tiltSpeedMax;
+    zoomSpeedMax = m.zoomSpeedMax;
+
+    auto setup = [](State &s, double min, double max, double ratePerSec, double tolerance) {
+        s.min = min;
+        s.max = max;
+        s.rate = ratePerSec / 1000.0;
+        s.tolerance = tolerance;
+    };
+    setup(axes[Pan], m.panMin, m.panMax, m.panRate, m.panRate * TOLERANCE_MS / 1000.0);
+    setup(axes[Tilt], m.tiltMin, m.tiltMax, m.tiltRate, m.tiltRate * TOLERANCE_MS / 1000.0);
+    setup(axes[Zoom], 0, m.zoomMax, m.zoomRate, m.zoomMax * ZOOM_TOLERANCE);
+}
+
+void PoseEstimator::reset()
+{
+    for (State &s : axes) {
+        s.known = false;
+        s.velocity = 0;
+        s.sigma = 0;
+        s.external = false;
+        s.settling = false;
+        s.clamped = false;
+        s.predicted = 0;
+    }
+    lastMs = -1;
+}
+
+void PoseEstimator::setScale(Axis a, double s)
+{
+    axes[a].scale = std::clamp(s, 0.5, 2.0);
+}
+
+bool PoseEstimator::active() const
+{
+    return std::any_of(axes.begin(), axes.end(),
+                       [](const State &s) { return s.known && (s.velocity != 0 || s.external); });
+}
+
+bool PoseEstimator::needsCorrection(Axis a) const
+{
+    const State &s = axes[a];
+    return s.known && s.sigma > s.tolerance;
+}
+
+bool PoseEstimator::estimated() const
+{
+    return std::any_of(axes.begin(), axes.end(), [](const State &s) {
+        return s.known && (s.sigma > 0 || s.velocity != 0 || s.external);
+    });
+}
+
+void PoseEstimator::advance(std::int64_t nowMs)
+{
+    if (lastMs < 0) { lastMs = nowMs; return; }
+    const double dt = double(nowMs - lastMs);
+    lastMs = nowMs;
+    if (dt <= 0) return;
+
+    for (State &s : axes) {
+        if (!s.known) continue;
+        if (s.external) {
+            // Somewhere between here and wherever the move ends
+            s.sigma = std::min(s.sigma + s.rate * dt, s.max - s.min);
+            continue;
+        }
+        if (s.velocity == 0) continue;
+        const double step = s.velocity * dt;
+        const double next = std::clamp(s.value + step, s.min, s.max);
+        if (next != s.value + step) s.clamped = true;
+        s.predicted += next - s.value;
+        s.value = next;
+        s.sigma = std::min(s.sigma + std::abs(step) * RATE_ERROR, s.max - s.min);
+    }
+}
+
+void PoseEstimator::drive(Axis a, double fraction, std::int64_t nowMs)
+{
+    advance(nowMs);
+    State &s = axes[a];
+    const double v = fraction * s.rate * s.scale;
+    if (s.known && !s.external) s.sigma += std::abs(v - s.velocity) * TIMING_MS;
+    s.velocity = v;
+}
+
+void PoseEstimator::startExternal(Axis a)
+{
+    State &s = axes[a];
+    s.external = true;
+    s.settling = false;
+    s.velocity = 0;
+}
+
+void PoseEstimator::onSent(const visca::Byte *b, std::size_t n, std::int64_t nowMs)
+{
+    if (n < 5 || (b[0] != (0x80 | address) && b[0] != 0x88) || b[1] != 0x01) return;
+    const visca::Byte cat = b[2], cmd = b[3];
+
+    if (cat == 0x06 && cmd == 0x01 && n >= 9) {          // Pan-tiltDrive vv ww 0p 0q
+        const double pan = std::min(1.0, double(b[4]) / panSpeedMax);
+        const double tilt = std::min(1.0, double(b[5]) / tiltSpeedMax);
+        // Right is +pan, up is +tilt
+        drive(Pan, b[6] == visca::PAN_RIGHT ? pan : b[6] == visca::PAN_LEFT ? -pan : 0, nowMs);
+        drive(Tilt, b[7] == visca::TILT_UP ? tilt : b[7] == visca::TILT_DOWN ? -tilt : 0, nowMs);
+    } else if (cat == 0x04 && cmd == 0x07) {              // Zoom stop / tele / wide
+        const int p = b[4] & 0x0F;
+        const bool variable = (b[4] & 0xF0) != 0;
+        // Standard speed is about the middle of the variable range
+        const double speed = double((variable ? p : zoomSpeedMax / 2) + 1) / (zoomSpeedMax + 1);
+        const bool tele = b[4] == 0x02 || (b[4] & 0xF0) == 0x20;
+        const bool wide = b[4] == 0x03 || (b[4] & 0xF0) == 0x30;
+        drive(Zoom, tele ? speed : wide ? -speed : 0, nowMs);
+    } else if ((cat == 0x04 && cmd == 0x3F && b[4] == 0x02)
+               || (cat == 0x04 && cmd == 0x00)) {         // preset recall, power
+        advance(nowMs);
+        startExternal(Pan);
+        startExternal(Tilt);
+        startExternal(Zoom);
+    } else if (cat == 0x06 && (cmd == 0x02 || cmd == 0x03 || cmd == 0x04)) {   // absolute, relative, home
+        advance(nowMs);
+        startExternal(Pan);
+        startExternal(Tilt);
+    } else if (cat == 0x04 && cmd == 0x47) {              // zoom direct
+        advance(nowMs);
+        startExternal(Zoom);
+    }
+}
+
+void PoseEstimator::measured(Axis a, int v)
+{
+    State &s = axes[a];
+    if (s.known && !s.external && !s.clamped && s.predicted != 0) {
+        // Learn from travel long enough to swamp timing noise
+        const double actual = v - s.lastMeasured;
+        if (std::abs(s.predicted) > 4 * s.tolerance && (actual > 0) == (s.predicted > 0)) {
+            const double ratio = std::clamp(actual / s.predicted, 0.5, 2.0);
+            setScale(a, s.scale * (1 + LEARN_GAIN * (ratio - 1)));
+        }
+    }
+    // External motion is over once the camera reports the same place twice
+    // after it began; the first reply may predate the move starting
+    if (s.external) {
+        if (s.settling && v == s.lastMeasured) s.external = false;
+        s.settling = true;
+    }
+
+    s.known = true;
+    s.value = v;
+    s.sigma = std::abs(s.velocity) * REPLY_LAG_MS;
+    s.predicted = 0;
+    s.clamped = false;
+    s.lastMeasured = v;
+}
+
+void PoseEstimator::measuredPanTilt(int pan, int tilt, std::int64_t nowMs)
+{
+    advance(nowMs);
+    measured(Pan, pan);
+    measured(Tilt, tilt);
+}
+
+void PoseEstimator::measuredZoom(int zoom, std::int64_t nowMs)
+{
+    advance(nowMs);
+    measured(Zoom, zoom);
+}
+
+void PoseEstimator::restored(Axis a, int v)
+{
+    State &s = axes[a];
+    s.known = true;
+    s.value = v;
+    s.velocity = 0;
+    s.sigma = s.max - s.min;
+    s.external = false;
+    s.settling = false;
+    s.clamped = false;
+    s.predicted = 0;
+    s.lastMeasured = v;
+}
@@ -0,0 +1,86 @@
+#ifndef POSEESTIMATOR_H
+#define POSEESTIMATOR_H
+
+// Dead-reckoning pan/tilt/zoom between position replies.
+//
+// Every frame we send passes through onSent(): Pan-tiltDrive and variable
+// zoom set an axis velocity from the speed code and the model's calibrated
+// rate (CameraModel::panRate etc., speed codes ~linear), and the estimate
+// integrates it. Moves whose path we can't predict (preset recall, absolute
+// and relative moves, home, zoom direct, power) put the axis into
+// "external" mode until two equal replies show it has stopped.
+//
+// Each axis carries an uncertainty that grows with speed (rate error),
+// with every start/stop (command and motor timing) and, in external mode,
+// at the axis' full rate. A position reply resets it. The caller only asks
+// the camera when needsCorrection() says the uncertainty has outgrown the
+// tolerance, so a short nudge costs no inquiry at all and a long pan costs
+// one every half second or so instead of a steady poll.
+//
+// Replies after drives also calibrate: the ratio of measured to predicted
+// travel nudges a per-axis scale, which the caller can persist per model.
+
+#include "cameramodels.h"
+#include "visca.h"
+
+#include <array>
+#include <cstdint>
+
+class PoseEstimator
+{
+public:
+    enum Axis { Pan, Tilt, Zoom, AXES };
+
+    void setModel(const CameraModel &m, int address);
+    void reset();                                    // nothing known
+
+    void onSent(const visca::Byte *frame, std::size_t size, std::int64_t nowMs);
+    void measuredPanTilt(int pan, int tilt, std::int64_t nowMs);
+    void measuredZoom(int zoom, std::int64_t nowMs);
+    // A value kept from an earlier session: known, but as uncertain as the
+    // axis' whole range, so needsCorrection() asks the camera for it.
+    void restored(Axis a, int v);
+
+    // Integrates up to `nowMs`; call before reading.
+    void advance(std::int64_t nowMs);
+
+    int    value(Axis a) const { return int(axes[a].value + (axes[a].value < 0 ? -0.5 : 0.5)); }
+    bool   known(Axis a) const { return axes[a].known; }
+    double uncertainty(Axis a) const { return axes[a].sigma; }
+    // True while any axis may be changing; the caller can idle otherwise.
+    bool   active() const;
+    bool   needsCorrection(Axis a) const;
+    // Estimate differs from the last reply (or has grown uncertain).
+    bool   estimated() const;
+
+    double scale(Axis a) const { return axes[a].scale; }
+    void   setScale(Axis a, double s);
+
+private:
+    struct State {
+        bool   known = false;
+        double value = 0;
+        double velocity = 0;        // units per ms, calibration applied
+        double sigma = 0;           // units
+        bool   external = false;
+        bool   settling = false;    // external, and one reply seen since it began
+        bool   clamped = false;     // hit a limit since the last reply
+        double predicted = 0;       // travel since the last reply
+        int    lastMeasured = 0;
+        double scale = 1.0;
+        double min = 0, max = 0;
+        double rate = 0;            // units per ms at full speed, uncalibrated
+        double tolerance = 0;
+    };
+
+    void drive(Axis a, double fraction, std::int64_t nowMs);   // -1..1 of full speed
+    void startExternal(Axis a);
+    void measured(Axis a, int v);
+
+    std::array<State, AXES> axes{};
+    std::int64_t lastMs = -1;
+    int address = 1;
+    int panSpeedMax = 0x18, tiltSpeedMax = 0x14, zoomSpeedMax = 7;
+};
+
+#endif // POSEESTIMATOR_H
@@ -0,0 +1,150 @@
+#include "serialtuning.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSerialPort>
+
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <cstring>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#endif
+
+QString SerialTuning::Report::describe() const
+{
+    QStringList done;
+    if (lowLatencyFlag) done << "ASYNC_LOW_LATENCY";
+    if (termios) done << "VMIN 1/VTIME 0";
+    if (timerBeforeMs >= 0 && timerAfterMs != timerBeforeMs)
+        done << QString("latency_timer %1→%2 ms").arg(timerBeforeMs).arg(timerAfterMs);
+    else if (timerBeforeMs >= 0)
+        done << QString("latency_timer %1 ms").arg(timerBeforeMs);
+    QString s = done.isEmpty() ? QString("nothing applied") : done.join(", ");
+    if (!problems.isEmpty()) s += "; " + problems.join("; ");
+    return s;
+}
+
+#if defined(Q_OS_LINUX)
+
+static int readTimer(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return -1;
+    bool ok = false;
+    const int ms = f.readAll().trimmed().toInt(&ok);
+    return ok ? ms : -1;
+}
+
+static bool writeTimer(const QString &path, int ms)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    return f.write(QByteArray::number(ms)) > 0;
+}
+
+bool SerialTuning::supported()
+{
+    return true;
+}
+
+SerialTuning::Report SerialTuning::apply(QSerialPort &port, const QString &portPath)
+{
+    restore();
+    Report r;
+    if (!port.isOpen() || port.handle() < 0) {
+        r.problems << "port not open";
+        last = r;
+        return r;
+    }
+    fd = port.handle();
+
+    serial_struct ss{};
+    if (::ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+        const int before = ss.flags;
+        ss.flags |= ASYNC_LOW_LATENCY;
+        if (before & ASYNC_LOW_LATENCY) {
+            r.lowLatencyFlag = true;
+        } else if (::ioctl(fd, TIOCSSERIAL, &ss) == 0) {
+            r.lowLatencyFlag = true;
+            savedAsyncFlags = before;
+        } else {
+            r.problems << QString("ASYNC_LOW_LATENCY: %1").arg(std::strerror(errno));
+        }
+    } else {
+        r.problems << "no serial_struct (not a UART driver)";
+    }
+
+    termios tio{};
+    if (::tcgetattr(fd, &tio) == 0) {
+        const int vmin = tio.c_cc[VMIN], vtime = tio.c_cc[VTIME];
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        if (::tcsetattr(fd, TCSANOW, &tio) == 0) {
+            r.termios = true;
+            savedVmin = vmin;
+            savedVtime = vtime;
+        } else {
+            r.problems << QString("termios: %1").arg(std::strerror(errno));
+        }
+    }
+
+    // /dev/serial/by-id links resolve to the ttyUSBn the sysfs node is named after
+    const QString dev = QFileInfo(QFileInfo(portPath).canonicalFilePath()).fileName();
+    const QString path = "/sys/class/tty/" + dev + "/device/latency_timer";
+    r.timerBeforeMs = r.timerAfterMs = readTimer(path);
+    if (r.timerBeforeMs > TARGET_TIMER_MS) {
+        if (writeTimer(path, TARGET_TIMER_MS)) {
+            timerPath = path;
+            savedTimerMs = r.timerBeforeMs;
+            r.timerAfterMs = readTimer(path);
+        } else {
+            r.problems << QString("%1 not writable (needs root or a udev rule)").arg(path);
+        }
+    }
+    last = r;
+    return r;
+}
+
+void SerialTuning::restore()
+{
+    if (fd >= 0) {
+        serial_struct ss{};
+        if (savedAsyncFlags >= 0 && ::ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+            ss.flags = savedAsyncFlags;
+            ::ioctl(fd, TIOCSSERIAL, &ss);
+        }
+        termios tio{};
+        if (savedVmin >= 0 && ::tcgetattr(fd, &tio) == 0) {
+            tio.c_cc[VMIN] = cc_t(savedVmin);
+            tio.c_cc[VTIME] = cc_t(savedVtime);
+            ::tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+    if (savedTimerMs >= 0) writeTimer(timerPath, savedTimerMs);
+    fd = -1;
+    savedAsyncFlags = savedVmin = savedVtime = savedTimerMs = -1;
+    timerPath.clear();
+}
+
+#else
+
+bool SerialTuning::supported()
+{
+    return false;
+}
+
+SerialTuning::Report SerialTuning::apply(QSerialPort &, const QString &)
+{
+    Report r;
+    r.problems << "only available on Linux";
+    last = r;
+    return r;
+}
+
+void SerialTuning::restore()
+{
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SERIALTUNING_H
+#define SERIALTUNING_H
+
+// Opt-in low-latency mode for USB-serial adapters (Linux only).
+//
+// FTDI and similar adapters hold received bytes until their latency timer
+// (16 ms by default) expires, so every ACK reaches us up to 16 ms late no
+// matter how fast the app is; QSerialPort has no knob for it. apply() takes
+// the open port and
+//   - sets ASYNC_LOW_LATENCY (TIOCSSERIAL), which tells the tty layer to
+//     push received data immediately and, on some drivers, lowers the
+//     adapter timer itself
+//   - sets VMIN 1 / VTIME 0 so a blocking read returns on the first byte
+//     (QSerialPort reads nonblocking, where these have no effect, but they
+//     keep the descriptor sane for anything else sharing it)
+//   - writes 1 ms to /sys/class/tty/<dev>/device/latency_timer when we are
+//     allowed to (root, or a udev rule granting write access)
+// Each step that fails is reported instead; on a pty only the termios part
+// applies. restore() puts back what apply() changed, since the sysfs timer
+// outlives our process.
+
+#include <QString>
+#include <QStringList>
+
+class QSerialPort;
+
+class SerialTuning
+{
+public:
+    static const int TARGET_TIMER_MS = 1;
+
+    struct Report {
+        bool lowLatencyFlag = false;    // ASYNC_LOW_LATENCY set
+        bool termios = false;           // VMIN/VTIME applied
+        int  timerBeforeMs = -1;        // -1 = no latency_timer for this port
+        int  timerAfterMs = -1;
+        QStringList problems;
+
+        bool any() const { return lowLatencyFlag || termios || timerAfterMs != timerBeforeMs; }
+        QString describe() const;
+    };
+
+    static bool supported();
+
+    // `portPath` is the device node, e.g. /dev/ttyUSB0 or a by-id link
+    Report apply(QSerialPort &port, const QString &portPath);
+    void restore();
+    bool isApplied() const { return fd >= 0; }
+    const Report &lastReport() const { return last; }
+
+private:
+    int     fd = -1;
+    int     savedAsyncFlags = -1;       // -1 = not changed
+    int     savedVmin = -1, savedVtime = -1;
+    QString timerPath;
+    int     savedTimerMs = -1;
+    Report  last;
+};
+
+#endif // SERIALTUNING_H
@@ -0,0 +1,151 @@
+#include "sessionlog.h"
+#include "gzip.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static const int IDLE_SLEEP_MS = 25;    // consumer poll interval when the ring is empty
+
+SessionLog::~SessionLog()
+{
+    stop();
+}
+
+bool SessionLog::start(const Options &o)
+{
+    stop();
+    if (o.dir.isEmpty() || !QDir().mkpath(o.dir)) return false;
+    opt = o;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    running.store(true, std::memory_order_release);
+    worker = std::thread(&SessionLog::run, this);
+    return true;
+}
+
+void SessionLog::stop()
+{
+    if (!worker.joinable()) return;
+    running.store(false, std::memory_order_release);
+    worker.join();
+}
+
+void SessionLog::push(Kind k, const char *data, qsizetype size)
+{
+    if (!running.load(std::memory_order_relaxed)) return;
+    const std::uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == RING) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Record &r = ring[h % RING];
+    r.wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch()).count();
+    r.kind = k;
+    r.len = std::uint8_t(std::min<qsizetype>(size, sizeof r.data));
+    std::memcpy(r.data, data, r.len);
+    head.store(h + 1, std::memory_order_release);
+}
+
+void SessionLog::event(const QString &line)
+{
+    if (!running.load(std::memory_order_relaxed)) return;
+    const QByteArray u = line.toUtf8();
+    qsizetype n = std::min<qsizetype>(u.size(), sizeof(Record::data));
+    // Never cut a UTF-8 sequence in half
+    if (n < u.size())
+        while (n > 0 && (quint8(u[n]) & 0xC0) == 0x80) --n;
+    push(Kind::Event, u.constData(), n);
+}
+
+// -------------------- Writer thread --------------------
+
+static void appendHex(QByteArray &out, const char *data, int len)
+{
+    static const char HEX[] = "0123456789ABCDEF";
+    for (int i = 0; i < len; ++i) {
+        const auto b = quint8(data[i]);
+        out += HEX[b >> 4];
+        out += HEX[b & 0x0F];
+        if (i + 1 < len) out += ' ';
+    }
+}
+
+void SessionLog::run()
+{
+    QFile file;
+    qint64 openedMs = 0;
+    std::uint64_t reportedDrops = 0;
+    QByteArray batch;
+
+    auto rotate = [&] {
+        QString done, compressError;
+        if (file.isOpen()) {
+            done = file.fileName();
+            file.close();
+        }
+        const QDateTime now = QDateTime::currentDateTime();
+        file.setFileName(QDir(opt.dir).filePath(now.toString("'simpleptz-'yyyyMMdd-HHmmss'.log'")));
+        file.open(QIODevice::WriteOnly | QIODevice::Append);
+        openedMs = now.toMSecsSinceEpoch();
+
+        // In-process so it works where no gzip is installed; a failure
+        // leaves the plain file and says so at the top of the next one
+        if (opt.compress && !done.isEmpty() && !gzip::compressFile(done, &compressError))
+            file.write(QString("--- Could not compress %1: %2 ---\n")
+                           .arg(QDir(opt.dir).relativeFilePath(done), compressError).toUtf8());
+
+        // Names sort by time, so the oldest come first
+        QDir d(opt.dir);
+        const QStringList logs = d.entryList({"simpleptz-*.log", "simpleptz-*.log.gz"},
+                                             QDir::Files, QDir::Name);
+        for (qsizetype i = 0; i + opt.keepFiles < logs.size(); ++i) d.remove(logs[i]);
+    };
+    rotate();
+
+    while (true) {
+        const bool more = running.load(std::memory_order_acquire);
+        const std::uint32_t h = head.load(std::memory_order_acquire);
+        std::uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == h) {
+            if (!more) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+            continue;
+        }
+
+        batch.clear();
+        for (; t != h; ++t) {
+            const Record &r = ring[t % RING];
+            batch += QDateTime::fromMSecsSinceEpoch(r.wallMs).toString("yyyy-MM-dd HH:mm:ss.zzz ").toLatin1();
+            switch (r.kind) {
+            case Kind::Tx:    batch += "TX "; appendHex(batch, r.data, r.len); break;
+            case Kind::Rx:    batch += "RX "; appendHex(batch, r.data, r.len); break;
+            case Kind::Event: batch.append(r.data, r.len); break;
+            }
+            batch += '\n';
+            // Free slots as we go so a long batch doesn't starve the producer
+            if ((t & 63) == 63) tail.store(t + 1, std::memory_order_release);
+        }
+        tail.store(t, std::memory_order_release);
+
+        const std::uint64_t drops = dropped();
+        if (drops != reportedDrops) {
+            batch += QByteArray("--- ") + QByteArray::number(qulonglong(drops - reportedDrops))
+                     + " records dropped (disk too slow) ---\n";
+            reportedDrops = drops;
+        }
+
+        const bool old = QDateTime::currentMSecsSinceEpoch() - openedMs
+                         >= qint64(opt.rotateMinutes) * 60 * 1000;
+        if ((file.size() > 0 && file.size() + batch.size() > opt.maxBytes) || old) rotate();
+        file.write(batch);
+        file.flush();
+    }
+    file.close();
+}
@@ -0,0 +1,74 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+// On-disk session log of TX/RX frames and events.
+//
+// The GUI thread (which also does all serial I/O) only copies a fixed-size
+// record into a single-producer/single-consumer ring: no allocation, no
+// locks, no syscalls. A background thread formats the records, appends them
+// to simpleptz-<date>-<time>.log and rotates by size or age. Rotated files
+// can be gzip'ed (in-process, gzip.h) and the oldest are pruned. If the
+// disk stalls long enough for the ring to fill, records are dropped and
+// counted rather than ever blocking the sender; the count is written to the
+// log once it catches up.
+
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+class SessionLog
+{
+public:
+    struct Options {
+        QString dir;
+        qint64  maxBytes      = 16 * 1024 * 1024;   // rotate when a file grows past this
+        int     rotateMinutes = 60;                 // ... or gets this old
+        bool    compress      = false;              // gzip rotated files
+        int     keepFiles     = 100;                // prune beyond this many
+    };
+
+    SessionLog() = default;
+    ~SessionLog();
+    SessionLog(const SessionLog &) = delete;
+    SessionLog &operator=(const SessionLog &) = delete;
+
+    bool start(const Options &opt);
+    void stop();    // writes everything queued, then joins the thread
+    bool isRunning() const { return worker.joinable(); }
+    const QString &directory() const { return opt.dir; }
+
+    // Producer side; call from one thread only (the GUI thread).
+    void tx(const char *data, qsizetype size)    { push(Kind::Tx, data, size); }
+    void rx(const char *data, qsizetype size)    { push(Kind::Rx, data, size); }
+    void event(const QString &line);
+
+    std::uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    enum class Kind : std::uint8_t { Tx, Rx, Event };
+
+    // 128 bytes: a VISCA frame (<= 16 B) or an event line truncated to fit
+    struct Record {
+        std::int64_t  wallMs;
+        Kind          kind;
+        std::uint8_t  len;
+        char          data[118];
+    };
+    static constexpr std::uint32_t RING = 4096;   // power of two
+
+    void push(Kind k, const char *data, qsizetype size);
+    void run();
+
+    Options opt;
+    std::unique_ptr<Record[]> ring{new Record[RING]};   // 512 KiB, off the stack
+    alignas(64) std::atomic<std::uint32_t> head{0};   // next slot to write (producer)
+    alignas(64) std::atomic<std::uint32_t> tail{0};   // next slot to read (consumer)
+    alignas(64) std::atomic<std::uint64_t> droppedCount{0};
+    std::atomic<bool> running{false};
+    std::thread worker;
+};
+
+#endif // SESSIONLOG_H
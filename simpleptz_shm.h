@@ -0,0 +1,124 @@
+/*
+ * simpleptz_shm.h - read SimplePTZ's live camera state from shared memory.
+ *
+ * SimplePTZ publishes the decoded state of its camera into a POSIX shared
+ * memory segment named "/simpleptz-<profile>" (profile name with anything
+ * outside [A-Za-z0-9_-] replaced by '_'). Writes are guarded by a seqlock:
+ * one writer, any number of lock-free readers, no serial traffic.
+ *
+ *     const simpleptz_shm_t *shm = simpleptz_shm_open("Default");
+ *     simpleptz_state_t st;
+ *     if (shm && simpleptz_read(shm, &st) == 0 && (st.flags & SIMPLEPTZ_HAS_PAN_TILT))
+ *         printf("pan %d tilt %d\n", st.pan, st.tilt);
+ *
+ * Plain C99 (plus GCC/Clang __atomic builtins) so overlay and recording
+ * tools in either language can include it. Link with -lrt on older glibc.
+ */
+#ifndef SIMPLEPTZ_SHM_H
+#define SIMPLEPTZ_SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SIMPLEPTZ_SHM_MAGIC    0x5A545053u  /* "SPTZ" */
+#define SIMPLEPTZ_SHM_VERSION  1u
+#define SIMPLEPTZ_SHM_PREFIX   "/simpleptz-"
+
+/* simpleptz_state_t.flags */
+#define SIMPLEPTZ_CONNECTED     (1u << 0)
+#define SIMPLEPTZ_HAS_POWER     (1u << 1)
+#define SIMPLEPTZ_HAS_VERSION   (1u << 2)
+#define SIMPLEPTZ_HAS_ZOOM      (1u << 3)
+#define SIMPLEPTZ_HAS_FOCUS     (1u << 4)
+#define SIMPLEPTZ_HAS_PAN_TILT  (1u << 5)
+#define SIMPLEPTZ_ESTIMATED     (1u << 6)   /* pan/tilt/zoom predicted, not measured */
+
+/* All members are 32-bit so readers can copy word by word. */
+typedef struct simpleptz_state_t {
+    uint32_t flags;
+    uint32_t address;       /* VISCA address 1..7 */
+    uint32_t power_on;
+    uint32_t vendor;        /* CAM_VersionInq */
+    uint32_t model;
+    uint32_t rom;
+    int32_t  pan;           /* camera units, signed */
+    int32_t  tilt;
+    int32_t  zoom;          /* 0x0000 wide .. 0x4000 optical tele */
+    int32_t  focus;
+    uint32_t focus_mode;    /* 0 unknown, 1 auto, 2 manual */
+    uint32_t ae_mode;       /* VISCA AE mode byte, 0xFF unknown */
+    uint32_t updated_ms_lo; /* writer's monotonic clock, ms */
+    uint32_t updated_ms_hi;
+    uint32_t update_count;
+    uint32_t reserved[5];
+} simpleptz_state_t;
+
+typedef struct simpleptz_shm_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;           /* odd while the writer is mid-update */
+    uint32_t size;          /* sizeof(simpleptz_state_t) */
+    simpleptz_state_t state;
+} simpleptz_shm_t;
+
+/* Returns 0 on a consistent snapshot, -1 if the writer kept it busy. */
+static inline int simpleptz_read(const simpleptz_shm_t *shm, simpleptz_state_t *out)
+{
+    const uint32_t *src = (const uint32_t *)&shm->state;
+    uint32_t *dst = (uint32_t *)out;
+    size_t n = sizeof(simpleptz_state_t) / sizeof(uint32_t);
+    int tries;
+    for (tries = 0; tries < 1000; ++tries) {
+        uint32_t s1 = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+        size_t i;
+        if (s1 & 1u) continue;
+        for (i = 0; i < n; ++i)
+            dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == s1)
+            return 0;
+    }
+    return -1;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Maps the segment read-only; NULL if SimplePTZ isn't running that profile. */
+static inline const simpleptz_shm_t *simpleptz_shm_open(const char *profile)
+{
+    char name[128];
+    const simpleptz_shm_t *shm;
+    size_t i, p = sizeof(SIMPLEPTZ_SHM_PREFIX) - 1;
+    int fd;
+    snprintf(name, sizeof name, "%s", SIMPLEPTZ_SHM_PREFIX);
+    for (i = 0; profile[i] && p + 1 < sizeof name; ++i, ++p) {
+        char c = profile[i];
+        int ok = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')
+                 || c == '_' || c == '-';
+        name[p] = ok ? c : '_';
+    }
+    name[p] = '\0';
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    shm = (const simpleptz_shm_t *)mmap(NULL, sizeof(simpleptz_shm_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) return NULL;
+    if (shm->magic != SIMPLEPTZ_SHM_MAGIC || shm->version != SIMPLEPTZ_SHM_VERSION) {
+        munmap((void *)shm, sizeof(simpleptz_shm_t));
+        return NULL;
+    }
+    return shm;
+}
+
+static inline void simpleptz_shm_close(const simpleptz_shm_t *shm)
+{
+    if (shm) munmap((void *)shm, sizeof(simpleptz_shm_t));
+}
+#endif
+
+#endif /* SIMPLEPTZ_SHM_H */
@@ -0,0 +1,199 @@
+#include "soakrunner.h"
+#include "mainwindow.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPlainTextEdit>
+#include <QComboBox>
+
+#include <cstdio>
+#include <numeric>
+
+static const int SAMPLE_MS = 250;
+static const int DRAIN_MS  = 500;    // longer than any simulated completion
+
+SoakRunner::SoakRunner(MainWindow &win, const Options &o, QObject *parent)
+    : QObject(parent), w(win), opt(o),
+      sim(ViscaSimulator::Options{.errorRate = o.errorRate}, this)
+{
+    actionTimer.setInterval(1000 / std::max(1, opt.actionsHz));
+    pollTimer.setInterval(1000 / std::max(1, opt.pollHz));
+    sampleTimer.setInterval(SAMPLE_MS);
+    connect(&actionTimer, &QTimer::timeout, this, &SoakRunner::act);
+    connect(&pollTimer,   &QTimer::timeout, this, &SoakRunner::poll);
+    connect(&sampleTimer, &QTimer::timeout, this, &SoakRunner::sample);
+}
+
+void SoakRunner::start()
+{
+    if (!sim.open()) {
+        std::fprintf(stderr, "soak: cannot create a pseudo-terminal for the simulator\n");
+        QCoreApplication::exit(2);
+        return;
+    }
+    w.portCombo->addItem(sim.devicePath());
+    w.portCombo->setCurrentText(sim.devicePath());
+    w.lowLatency = opt.lowLatency;
+    w.connectOrDisconnect();
+    if (!w.serial.isOpen()) {
+        std::fprintf(stderr, "soak: cannot open %s\n", qPrintable(sim.devicePath()));
+        QCoreApplication::exit(2);
+        return;
+    }
+    w.linkStats = LinkStats{};
+    w.statsAtConnect = w.linkStats;
+    lostAtStart = w.sentFrames.lost();
+
+    clock.start();
+    actionTimer.start();
+    pollTimer.start();
+    sampleTimer.start();
+    QTimer::singleShot(opt.seconds * 1000, this, &SoakRunner::finish);
+}
+
+void SoakRunner::act()
+{
+    ++actions;
+    const int r = int(rng.bounded(10));
+    if (r < 5) {
+        int dx = 0, dy = 0;
+        while (!dx && !dy) {
+            dx = int(rng.bounded(3)) - 1;
+            dy = int(rng.bounded(3)) - 1;
+        }
+        w.ptzPressed(dx, dy);
+        QTimer::singleShot(int(rng.bounded(30, 200)), this, [this] { w.ptzReleased(); });
+    } else if (r < 8) {
+        if (rng.bounded(2)) w.zoomInPressed(); else w.zoomOutPressed();
+        QTimer::singleShot(int(rng.bounded(30, 200)), this, [this] { w.zoomReleased(); });
+    } else if (r < 9) {
+        w.sendRecallPreset(int(rng.bounded(w.cameraModel->presetCount)));
+    } else {
+        w.sendRefocus();
+    }
+}
+
+void SoakRunner::poll()
+{
+    w.sendInquiry((polls++ % 2) ? visca::Inquiry::ZoomPos : visca::Inquiry::PanTiltPos);
+}
+
+void SoakRunner::sample()
+{
+    const qint64 rss = residentKb();
+    rssPeakKb = std::max(rssPeakKb, rss);
+    // Ignore start-up allocations: growth counts from the end of the first tenth
+    if (rssStartKb < 0 && clock.elapsed() >= std::max<qint64>(1000, opt.seconds * 100))
+        rssStartKb = rss;
+    maxRxBuf = std::max(maxRxBuf, int(w.rxBuf.size()));
+    maxPendingInquiries = std::max(maxPendingInquiries, w.sentFrames.inquiries());
+}
+
+void SoakRunner::finish()
+{
+    driveMs = clock.elapsed();
+    actionTimer.stop();
+    pollTimer.stop();
+    QTimer::singleShot(DRAIN_MS, this, &SoakRunner::report);
+}
+
+qint64 SoakRunner::residentKb()
+{
+#if defined(Q_OS_LINUX)
+    QFile f("/proc/self/statm");
+    if (!f.open(QIODevice::ReadOnly)) return 0;
+    const QList<QByteArray> fields = f.readAll().split(' ');
+    if (fields.size() < 2) return 0;
+    return fields[1].toLongLong() * 4;   // pages; 4 KiB on every Linux we ship for
+#else
+    return 0;
+#endif
+}
+
+void SoakRunner::report()
+{
+    sampleTimer.stop();
+    sample();
+    const LinkStats &s = w.linkStats;
+    const ViscaSimulator::Counters &c = sim.counters();
+    const quint64 unanswered = w.sentFrames.lost() - lostAtStart + quint64(w.sentFrames.size());
+    const double secs = std::max<qint64>(1, driveMs) / 1000.0;
+    const double fps = double(s.framesTx) / secs;
+    const double p50 = s.latencyQuantileMs(0.50), p95 = s.latencyQuantileMs(0.95),
+                 p99 = s.latencyQuantileMs(0.99);
+    const double mean = s.latencyCount ? double(s.latencySumUs) / s.latencyCount / 1000.0 : 0;
+
+    // Buffer-full, cancelled and no-socket replies and injected errors are
+    // things a camera does; anything else means we sent or parsed wrongly.
+    const quint64 allErrors = std::accumulate(s.errors.begin(), s.errors.end(), quint64(0));
+    const quint64 expected = s.errors[3] + s.errors[4] + s.errors[5] + c.injectedErrors;
+    const qint64 failures = qint64(allErrors - std::min(allErrors, expected))
+                            + qint64(s.unknownRx + unanswered);
+    const qint64 rssEnd = residentKb();
+    const qint64 rssGrowth = rssStartKb >= 0 ? rssEnd - rssStartKb : 0;
+    const int logLines = w.rxView ? w.rxView->blockCount() : 0;
+
+    QStringList failed;
+    if (opt.minFps >= 0 && fps < opt.minFps)
+        failed << QString("frames/s %1 < %2").arg(fps, 0, 'f', 1).arg(opt.minFps);
+    if (opt.maxP99Ms >= 0 && p99 > opt.maxP99Ms)
+        failed << QString("p99 %1 ms > %2 ms").arg(p99).arg(opt.maxP99Ms);
+    if (opt.maxFailures >= 0 && failures > opt.maxFailures)
+        failed << QString("failures %1 > %2").arg(failures).arg(opt.maxFailures);
+    if (opt.maxRssKb >= 0 && rssGrowth > opt.maxRssKb)
+        failed << QString("rss growth %1 kB > %2 kB").arg(rssGrowth).arg(opt.maxRssKb);
+
+    std::printf("SimplePTZ soak: %.1f s, %lld actions, %lld polls\n", secs, actions, polls);
+    std::printf("  frames   tx %llu (%.1f/s, %llu B)  rx %llu (%llu B)\n",
+                (unsigned long long)s.framesTx, fps, (unsigned long long)s.bytesTx,
+                (unsigned long long)s.framesRx, (unsigned long long)s.bytesRx);
+    std::printf("  latency  p50 <=%.1f ms  p95 <=%.1f ms  p99 <=%.1f ms  mean %.2f ms (%llu replies)\n",
+                p50, p95, p99, mean, (unsigned long long)s.latencyCount);
+    std::printf("  errors   buffer-full %llu  injected %llu  other %llu  undecodable %llu  unanswered %llu\n",
+                (unsigned long long)s.errors[3], (unsigned long long)c.injectedErrors,
+                (unsigned long long)(allErrors - std::min(allErrors, expected)),
+                (unsigned long long)s.unknownRx, (unsigned long long)unanswered);
+    std::printf("  memory   rss %lld kB (peak %lld, +%lld after warm-up)  rxBuf max %d B  "
+                "inquiries max %d  log %d lines\n",
+                rssEnd, rssPeakKb, rssGrowth, maxRxBuf, maxPendingInquiries, logLines);
+    if (opt.lowLatency)
+        std::printf("  serial   low-latency: %s\n",
+                    qPrintable(w.serialTuning.lastReport().describe()));
+    std::printf("  camera   frames %llu  acks %llu  completions %llu  inquiry replies %llu\n",
+                (unsigned long long)c.framesIn, (unsigned long long)c.acks,
+                (unsigned long long)c.completions, (unsigned long long)c.inquiryReplies);
+    std::printf("%s%s\n", failed.isEmpty() ? "PASS" : "FAIL: ", qPrintable(failed.join("; ")));
+    std::fflush(stdout);
+
+    if (!opt.reportPath.isEmpty()) {
+        QJsonArray buckets;
+        for (quint64 n : s.latency) buckets.append(qint64(n));
+        QJsonArray bounds;
+        for (qint64 us : LinkStats::BUCKET_US) bounds.append(us);
+        const QJsonObject o{
+            {"seconds", secs}, {"actions", actions}, {"polls", polls},
+            {"framesTx", qint64(s.framesTx)}, {"framesRx", qint64(s.framesRx)},
+            {"framesPerSec", fps},
+            {"latencyP50Ms", p50}, {"latencyP95Ms", p95}, {"latencyP99Ms", p99},
+            {"latencyMeanMs", mean}, {"latencyBucketsUs", bounds}, {"latencyCounts", buckets},
+            {"bufferFull", qint64(s.errors[3])}, {"injectedErrors", qint64(c.injectedErrors)},
+            {"failures", failures},
+            {"rssKb", rssEnd}, {"rssPeakKb", rssPeakKb}, {"rssGrowthKb", rssGrowth},
+            {"maxRxBuf", maxRxBuf}, {"maxPendingInquiries", maxPendingInquiries},
+            {"logLines", logLines},
+            {"lowLatency", opt.lowLatency},
+            {"pass", failed.isEmpty()}, {"failed", QJsonArray::fromStringList(failed)},
+        };
+        QFile f(opt.reportPath);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            f.write(QJsonDocument(o).toJson());
+        else
+            std::fprintf(stderr, "soak: cannot write %s\n", qPrintable(opt.reportPath));
+    }
+
+    if (w.serial.isOpen()) w.connectOrDisconnect();
+    QCoreApplication::exit(failed.isEmpty() ? 0 : 1);
+}
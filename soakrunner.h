@@ -0,0 +1,74 @@
+#ifndef SOAKRUNNER_H
+#define SOAKRUNNER_H
+
+// Soak / load run: `SimplePTZ --soak <seconds>`.
+//
+// Connects the real window to a ViscaSimulator over a pty and drives it with
+// random pad, zoom and preset input plus position polling at fixed rates,
+// all through the normal slots, sendVisca and processIncomingFrames. At the
+// end it prints frames/s, reply latency percentiles, error counts and
+// memory growth, optionally writes them as JSON, and exits nonzero when a
+// threshold is missed so CI can catch throughput or latency regressions.
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include "viscasim.h"
+
+class MainWindow;
+
+class SoakRunner : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options {
+        int     seconds     = 60;
+        int     actionsHz   = 20;     // operator input events per second
+        int     pollHz      = 10;     // position inquiries per second
+        double  errorRate   = 0.0;    // simulator-injected syntax errors
+        bool    lowLatency  = false;  // run with serialtuning.h applied to the pty
+        int     links       = 0;      // > 0: LinkSoak with this many cameras instead
+        int     reactors    = 0;      // LinkSoak reactor threads, 0 = one per core
+        // Thresholds; a negative value disables the check
+        double  minFps      = -1;     // frames written per second
+        double  maxP99Ms    = -1;     // reply latency
+        qint64  maxFailures = 0;      // unexplained errors, undecodable or unanswered frames
+        qint64  maxRssKb    = -1;     // resident set growth after warm-up
+        QString reportPath;           // JSON copy of the report
+    };
+
+    SoakRunner(MainWindow &w, const Options &opt, QObject *parent = nullptr);
+
+    // Starts the run; the application exits with the verdict when it ends.
+    void start();
+
+    static qint64 residentKb();
+
+private:
+    void act();
+    void poll();
+    void sample();
+    void finish();   // stop driving, let replies drain, then report()
+    void report();
+
+    MainWindow &w;
+    Options opt;
+    ViscaSimulator sim;
+    QTimer actionTimer;
+    QTimer pollTimer;
+    QTimer sampleTimer;
+    QElapsedTimer clock;
+    QRandomGenerator rng{0x534F414B};   // fixed seed: runs are comparable
+    qint64 driveMs = 0;
+    qint64 actions = 0;
+    qint64 polls = 0;
+    qint64 rssStartKb = -1;      // taken once the warm-up is over
+    qint64 rssPeakKb = 0;
+    int    maxRxBuf = 0;
+    int    maxPendingInquiries = 0;
+    quint64 lostAtStart = 0;     // SentFrames::lost() before the run
+};
+
+#endif // SOAKRUNNER_H
@@ -0,0 +1,106 @@
+#include "statepublisher.h"
+
+#include <QElapsedTimer>
+
+#if defined(Q_OS_UNIX)
+#include "simpleptz_shm.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+StatePublisher::~StatePublisher()
+{
+    close();
+}
+
+#if defined(Q_OS_UNIX)
+
+bool StatePublisher::open(const QString &profile)
+{
+    close();
+    QByteArray n = SIMPLEPTZ_SHM_PREFIX;
+    for (QChar c : profile) {
+        const ushort u = c.unicode();
+        const bool ok = (u >= 'A' && u <= 'Z') || (u >= 'a' && u <= 'z') || (u >= '0' && u <= '9')
+                        || u == '_' || u == '-';
+        n += ok ? char(u) : '_';
+    }
+
+    const int fd = ::shm_open(n.constData(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    if (::ftruncate(fd, sizeof(simpleptz_shm_t)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void *p = ::mmap(nullptr, sizeof(simpleptz_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    shm = static_cast<simpleptz_shm_t *>(p);
+    name = n;
+    // A stale segment from a crashed run may be mid-update (odd seq): restart it
+    __atomic_store_n(&shm->seq, 0u, __ATOMIC_RELAXED);
+    shm->version = SIMPLEPTZ_SHM_VERSION;
+    shm->size = sizeof(simpleptz_state_t);
+    __atomic_store_n(&shm->magic, SIMPLEPTZ_SHM_MAGIC, __ATOMIC_RELEASE);
+    publish(CameraState{}, 0, false);
+    return true;
+}
+
+void StatePublisher::close()
+{
+    if (!shm) return;
+    ::munmap(shm, sizeof(simpleptz_shm_t));
+    ::shm_unlink(name.constData());
+    shm = nullptr;
+    name.clear();
+}
+
+void StatePublisher::publish(const CameraState &s, int address, bool connected, bool estimated)
+{
+    if (!shm) return;
+
+    simpleptz_state_t st{};
+    st.flags = (connected      ? SIMPLEPTZ_CONNECTED    : 0)
+             | (s.powerKnown   ? SIMPLEPTZ_HAS_POWER    : 0)
+             | (s.versionKnown ? SIMPLEPTZ_HAS_VERSION  : 0)
+             | (s.zoomKnown    ? SIMPLEPTZ_HAS_ZOOM     : 0)
+             | (s.focusKnown   ? SIMPLEPTZ_HAS_FOCUS    : 0)
+             | (s.panTiltKnown ? SIMPLEPTZ_HAS_PAN_TILT : 0)
+             | (estimated      ? SIMPLEPTZ_ESTIMATED    : 0);
+    st.address    = quint32(address);
+    st.power_on   = s.powerOn;
+    st.vendor     = s.version.vendor;
+    st.model      = s.version.model;
+    st.rom        = s.version.rom;
+    st.pan        = s.pan;
+    st.tilt       = s.tilt;
+    st.zoom       = s.zoom;
+    st.focus      = s.focus;
+    st.focus_mode = quint32(s.focusMode);
+    st.ae_mode    = quint32(s.aeMode);
+    const quint64 ms = quint64(QElapsedTimer::msecsSinceReference());
+    st.updated_ms_lo = quint32(ms);
+    st.updated_ms_hi = quint32(ms >> 32);
+    st.update_count  = ++updates;
+
+    // Seqlock write: odd seq, release fence, payload, even seq (release)
+    const quint32 seq = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    auto *dst = reinterpret_cast<quint32 *>(&shm->state);
+    const auto *src = reinterpret_cast<const quint32 *>(&st);
+    for (std::size_t i = 0; i < sizeof(st) / sizeof(quint32); ++i)
+        __atomic_store_n(&dst[i], src[i], __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+#else // no POSIX shared memory: publishing is disabled
+
+bool StatePublisher::open(const QString &) { return false; }
+void StatePublisher::close() {}
+void StatePublisher::publish(const CameraState &, int, bool, bool) {}
+
+#endif
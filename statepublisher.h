@@ -0,0 +1,35 @@
+#ifndef STATEPUBLISHER_H
+#define STATEPUBLISHER_H
+
+// Publishes CameraState into the shared-memory segment described in
+// simpleptz_shm.h (seqlock writer side). POSIX only; elsewhere open()
+// fails and publish() is a no-op.
+
+#include <QString>
+
+#include "camerastate.h"
+
+struct simpleptz_shm_t;
+
+class StatePublisher
+{
+public:
+    StatePublisher() = default;
+    ~StatePublisher();
+    StatePublisher(const StatePublisher &) = delete;
+    StatePublisher &operator=(const StatePublisher &) = delete;
+
+    // (Re)creates "/simpleptz-<profile>"; the previous segment is unlinked.
+    bool open(const QString &profile);
+    void close();
+    bool isOpen() const { return shm != nullptr; }
+
+    void publish(const CameraState &s, int address, bool connected, bool estimated = false);
+
+private:
+    simpleptz_shm_t *shm = nullptr;
+    QByteArray name;
+    quint32 updates = 0;
+};
+
+#endif // STATEPUBLISHER_H
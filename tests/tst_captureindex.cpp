@@ -0,0 +1,161 @@
+#include "captureindex.h"
+#include "gzip.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace {
+
+// Two cameras; errors follow recalls of presets 5 and 3
+const char CAPTURE[] =
+    "2026-03-01 10:00:00.000 --- Connected to /dev/ttyUSB0 ---\n"
+    "2026-03-01 10:00:00.100 TX 81 01 04 3F 02 05 FF\n"     //  1 recall 5, cam 1
+    "2026-03-01 10:00:00.120 RX 90 41 FF\n"
+    "2026-03-01 10:00:01.500 RX 90 51 FF\n"
+    "2026-03-01 10:00:02.000 TX 81 01 06 01 0C 0C 01 03 FF\n"
+    "2026-03-01 10:00:02.010 RX 90 60 03 FF\n"              //  5 buffer full after recall 5
+    "2026-03-01 10:00:03.000 TX 81 01 04 3F 02 03 FF\n"     //  6 recall 3
+    "2026-03-01 10:00:03.010 RX 90 61 41 FF\n"              //  7 not executable after recall 3
+    "2026-03-01 10:00:04.000 --- Link lost, reconnecting ---\n"
+    "2026-03-01 10:00:05.000 TX 82 01 04 3F 02 05 FF\n"     //  9 recall 5, cam 2
+    "2026-03-01 10:00:05.020 RX A0 60 02 FF\n"              // 10 syntax after recall 5
+    "2026-03-01 10:00:40.000 RX 90 62 41 FF\n"              // 11 cam 1, still after recall 3
+    "2026-03-01 10:00:41.000 TX 81 09 06 12 FF\n"
+    "2026-03-01 10:00:41.030 RX 90 50 00 00 01 02 0F 0F 0E 0C FF\n";
+
+std::vector<quint32> find(const CaptureIndex &index, const QString &text, std::size_t *total = nullptr)
+{
+    CaptureIndex::Query q;
+    QString error;
+    if (!index.parse(text, q, &error)) {
+        qWarning("%s: %s", qPrintable(text), qPrintable(error));
+        return {quint32(-1)};
+    }
+    return index.find(q, 100, total);
+}
+
+using Hits = std::vector<quint32>;
+
+} // namespace
+
+class TestCaptureIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void classify();
+    void find_data();
+    void find();
+    void limit();
+    void badQueries_data();
+    void badQueries();
+    void gzipSegments();
+
+private:
+    QTemporaryDir dir;
+    QString path;
+    CaptureIndex index;
+};
+
+void TestCaptureIndex::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    path = dir.filePath("session.log");
+    QFile f(path);
+    QVERIFY(f.open(QIODevice::WriteOnly));
+    f.write(CAPTURE);
+    f.close();
+    QString error;
+    QVERIFY2(index.load({path}, &error), qPrintable(error));
+}
+
+void TestCaptureIndex::classify()
+{
+    QCOMPARE(index.size(), std::size_t(14));
+    QCOMPARE(index.frames(), std::size_t(12));
+    QVERIFY(index.format(1).endsWith("// recall 5, cam 1"));
+    QVERIFY(index.format(5).endsWith("// error buffer_full, cam 1"));
+    QVERIFY(index.format(10).endsWith("// error syntax, cam 2"));
+    QVERIFY(index.format(13).contains("// reply"));
+}
+
+void TestCaptureIndex::find_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<Hits>("hits");
+    QTest::newRow("errors after recall 5") << "error after:recall=5" << Hits{5, 10};
+    QTest::newRow("same camera only") << "error after:recall=5 cam:1" << Hits{5};
+    QTest::newRow("within") << "error after:recall=5 within:1" << Hits{10};
+    QTest::newRow("after any recall") << "error after:recall" << Hits{5, 7, 10, 11};
+    QTest::newRow("error by name") << "error=not_executable" << Hits{7, 11};
+    QTest::newRow("error by code") << "error=3" << Hits{5};
+    QTest::newRow("recall preset") << "recall=5" << Hits{1, 9};
+    QTest::newRow("time range") << "recall=5 from:10:00:04" << Hits{9};
+    QTest::newRow("to") << "rx to:10:00:02" << Hits{2, 3};
+    QTest::newRow("bytes") << "bytes:9?6" << Hits{5, 7, 11};
+    QTest::newRow("events") << "event text:lost" << Hits{8};
+    QTest::newRow("tx cam 2") << "tx cam:2" << Hits{9};
+    QTest::newRow("inquiry") << "inquiry" << Hits{12};
+}
+
+void TestCaptureIndex::find()
+{
+    QFETCH(QString, query);
+    QFETCH(Hits, hits);
+    std::size_t total = 0;
+    QCOMPARE(::find(index, query, &total), hits);
+    QCOMPARE(total, hits.size());
+}
+
+void TestCaptureIndex::limit()
+{
+    CaptureIndex::Query q;
+    QVERIFY(index.parse("rx", q, nullptr));
+    std::size_t total = 0;
+    QCOMPARE(index.find(q, 2, &total), (Hits{2, 3}));
+    QCOMPARE(total, std::size_t(7));
+}
+
+void TestCaptureIndex::badQueries_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::newRow("unknown term") << "bogus";
+    QTest::newRow("two types") << "error recall";
+    QTest::newRow("within without after") << "error within:2";
+    QTest::newRow("bad camera") << "cam:9";
+    QTest::newRow("bad error name") << "error=melted";
+    QTest::newRow("bad bytes") << "bytes:9x";
+    QTest::newRow("bad time") << "from:noon";
+}
+
+void TestCaptureIndex::badQueries()
+{
+    QFETCH(QString, query);
+    CaptureIndex::Query q;
+    QString error;
+    QVERIFY(!index.parse(query, q, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestCaptureIndex::gzipSegments()
+{
+    // A rotated, compressed segment followed by the live file
+    const QString gzPath = dir.filePath("session-1.log.gz");
+    QFile gz(gzPath);
+    QVERIFY(gz.open(QIODevice::WriteOnly));
+    gz.write(gzip::compress(QByteArray(CAPTURE)));
+    gz.close();
+
+    CaptureIndex both;
+    QString error;
+    QVERIFY2(both.load({gzPath, path}, &error), qPrintable(error));
+    QCOMPARE(both.size(), 2 * index.size());
+    std::size_t total = 0;
+    ::find(both, "error after:recall=5 cam:1", &total);
+    QCOMPARE(total, std::size_t(2));
+}
+
+QTEST_APPLESS_MAIN(TestCaptureIndex)
+#include "tst_captureindex.moc"
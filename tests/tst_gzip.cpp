@@ -0,0 +1,157 @@
+#include "gzip.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <cstdint>
+
+namespace {
+
+// Session-log-like text: repetitive, so deflate uses dynamic Huffman blocks
+QByteArray logText(int lines)
+{
+    QByteArray out;
+    for (int i = 0; i < lines; ++i)
+        out += QByteArray("2026-03-01 10:00:") + QByteArray::number(10 + i % 50) + ".000 TX 81 01 04 3F 02 0"
+               + QByteArray::number(i % 8) + " FF\n";
+    return out;
+}
+
+// Incompressible bytes, which deflate stores verbatim
+QByteArray noise(qsizetype size)
+{
+    QByteArray out(size, Qt::Uninitialized);
+    std::uint32_t x = 2463534242u;
+    for (qsizetype i = 0; i < size; ++i) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        out[i] = char(x);
+    }
+    return out;
+}
+
+// `gzip` output for three log lines, with the file name in the header
+const unsigned char GZIP_TOOL[] = {
+    0x1F, 0x8B, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x02, 0xFF, 0x73, 0x65, 0x73, 0x73, 0x69, 0x6F,
+    0x6E, 0x2E, 0x6C, 0x6F, 0x67, 0x00, 0x33, 0x32, 0x30, 0x32, 0xD3, 0x35, 0x30, 0xD6, 0x35, 0x30,
+    0x54, 0x30, 0x34, 0xB0, 0x32, 0x00, 0x21, 0x3D, 0x03, 0x03, 0x03, 0x85, 0x90, 0x08, 0x05, 0x0B,
+    0x43, 0x05, 0xA0, 0xA8, 0x81, 0x89, 0x82, 0xB1, 0x9B, 0x82, 0x81, 0x91, 0x82, 0x81, 0xA9, 0x82,
+    0x9B, 0x1B, 0x97, 0x11, 0x8D, 0xD5, 0x03, 0x00, 0xDB, 0xF9, 0x70, 0x01, 0x90, 0x00, 0x00, 0x00,
+};
+
+} // namespace
+
+class TestGzip : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void gzipToolOutput();
+    void multiMember();
+    void compressFileChunks();
+    void corrupt_data();
+    void corrupt();
+};
+
+void TestGzip::roundTrip_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::newRow("one byte") << QByteArray("x");
+    QTest::newRow("log") << logText(20000);
+    QTest::newRow("noise") << noise(200 * 1024);
+    QTest::newRow("mixed") << logText(500) + noise(70000) + logText(500);
+}
+
+void TestGzip::roundTrip()
+{
+    QFETCH(QByteArray, data);
+    const QByteArray gz = gzip::compress(data);
+    QVERIFY(!gz.isEmpty());
+    QByteArray out;
+    QString error;
+    QVERIFY2(gzip::decompress(gz, out, &error), qPrintable(error));
+    QCOMPARE(out, data);
+}
+
+void TestGzip::gzipToolOutput()
+{
+    QByteArray out;
+    QString error;
+    QVERIFY2(gzip::decompress(QByteArray(reinterpret_cast<const char *>(GZIP_TOOL), sizeof GZIP_TOOL), out, &error),
+             qPrintable(error));
+    QCOMPARE(out, QByteArray("2026-03-01 10:00:00.000 TX 81 01 04 3F 02 05 FF\n").repeated(3));
+}
+
+void TestGzip::multiMember()
+{
+    const QByteArray a = logText(300), b = noise(5000), c = "tail\n";
+    QByteArray gz = gzip::compress(a) + gzip::compress(b) + gzip::compress(c);
+    gz.append(16, '\0');   // padding some writers leave after the last member
+    QByteArray out;
+    QString error;
+    QVERIFY2(gzip::decompress(gz, out, &error), qPrintable(error));
+    QCOMPARE(out, a + b + c);
+}
+
+void TestGzip::compressFileChunks()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("session.log");
+    const QByteArray data = logText(int(3 * gzip::CHUNK / 48));   // a few members
+    {
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        QCOMPARE(f.write(data), data.size());
+    }
+    QString error;
+    QVERIFY2(gzip::compressFile(path, &error), qPrintable(error));
+    QVERIFY(!QFile::exists(path));
+
+    QFile gz(path + ".gz");
+    QVERIFY(gz.open(QIODevice::ReadOnly));
+    QByteArray out;
+    QVERIFY2(gzip::decompress(gz.readAll(), out, &error), qPrintable(error));
+    QCOMPARE(out, data);
+}
+
+void TestGzip::corrupt_data()
+{
+    QTest::addColumn<QByteArray>("gz");
+    QTest::addColumn<QString>("why");
+    const QByteArray good = gzip::compress(logText(100));
+
+    QByteArray crc = good;
+    crc[crc.size() - 8] = char(crc[crc.size() - 8] ^ 0x01);
+    QTest::newRow("crc") << crc << "CRC mismatch";
+
+    QByteArray length = good;
+    length[length.size() - 4] = char(length[length.size() - 4] + 1);
+    QTest::newRow("length") << length << "length mismatch";
+
+    QTest::newRow("truncated trailer") << good.left(good.size() - 3) << "truncated";
+
+    // A good first member doesn't hide a bad second one
+    QTest::newRow("second member crc") << good + crc << "CRC mismatch";
+
+    QByteArray method = good;
+    method[2] = 7;
+    QTest::newRow("method") << method << "not deflate";
+
+    QTest::newRow("not gzip") << QByteArray("plain text, not compressed at all") << "not a gzip file";
+}
+
+void TestGzip::corrupt()
+{
+    QFETCH(QByteArray, gz);
+    QFETCH(QString, why);
+    QByteArray out;
+    QString error;
+    QVERIFY(!gzip::decompress(gz, out, &error));
+    QCOMPARE(error, why);
+}
+
+QTEST_APPLESS_MAIN(TestGzip)
+#include "tst_gzip.moc"
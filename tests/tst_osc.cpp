@@ -0,0 +1,133 @@
+#include "osc.h"
+
+#include <QTest>
+
+#include <bit>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Builds OSC packets byte by byte, the way a console would send them
+struct Packet
+{
+    std::vector<std::uint8_t> bytes;
+
+    Packet &str(std::string_view s)
+    {
+        bytes.insert(bytes.end(), s.begin(), s.end());
+        do bytes.push_back(0); while (bytes.size() % 4);
+        return *this;
+    }
+    Packet &i32(std::uint32_t v)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8) bytes.push_back(std::uint8_t(v >> shift));
+        return *this;
+    }
+    Packet &f32(float v) { return i32(std::bit_cast<std::uint32_t>(v)); }
+    Packet &i64(std::uint64_t v) { return i32(std::uint32_t(v >> 32)).i32(std::uint32_t(v)); }
+    Packet &f64(double v) { return i64(std::bit_cast<std::uint64_t>(v)); }
+    Packet &packet(const Packet &p)
+    {
+        i32(std::uint32_t(p.bytes.size()));
+        bytes.insert(bytes.end(), p.bytes.begin(), p.bytes.end());
+        return *this;
+    }
+};
+
+std::vector<osc::Command> run(const Packet &p, bool *ok = nullptr)
+{
+    std::vector<osc::Command> out;
+    const bool decoded = osc::decode(p.bytes.data(), p.bytes.size(), [&](const osc::Message &m) {
+        osc::Command c;
+        if (osc::route(m, c)) out.push_back(c);
+    });
+    if (ok) *ok = decoded;
+    return out;
+}
+
+} // namespace
+
+class TestOsc : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void numberTypes();
+    void nonNumbersAreRejected();
+    void bundle();
+    void malformed();
+};
+
+void TestOsc::numberTypes()
+{
+    auto recall = run(Packet().str("/ptz/2/preset/recall").str(",i").i32(5));
+    QCOMPARE(recall.size(), std::size_t(1));
+    QCOMPARE(recall[0].kind, osc::Command::Recall);
+    QCOMPARE(recall[0].camera, 2);
+    QCOMPARE(recall[0].preset, 5);
+
+    auto drive = run(Packet().str("/ptz/1/drive").str(",fd").f32(0.5f).f64(-2.0));
+    QCOMPARE(drive.size(), std::size_t(1));
+    QCOMPARE(drive[0].kind, osc::Command::Drive);
+    QCOMPARE(drive[0].pan, 0.5);
+    QCOMPARE(drive[0].tilt, -1.0);   // clamped
+
+    auto store = run(Packet().str("/ptz/1/preset/store").str(",h").i64(7));
+    QCOMPARE(store.size(), std::size_t(1));
+    QCOMPARE(store[0].kind, osc::Command::Store);
+    QCOMPARE(store[0].preset, 7);
+}
+
+void TestOsc::nonNumbersAreRejected()
+{
+    // Nil and infinitum carry no data; they must not read as 0 or as a
+    // stale value
+    QVERIFY(run(Packet().str("/ptz/1/zoom").str(",N")).empty());
+    QVERIFY(run(Packet().str("/ptz/1/zoom").str(",I")).empty());
+    QVERIFY(run(Packet().str("/ptz/1/zoom").str(",T")).empty());
+    QVERIFY(run(Packet().str("/ptz/1/drive").str(",fN").f32(0.5f)).empty());
+    QVERIFY(run(Packet().str("/ptz/1/preset/recall").str(",s").str("3")).empty());
+    QVERIFY(run(Packet().str("/ptz/1/preset/recall").str(",c").i32('3')).empty());
+    QVERIFY(run(Packet().str("/ptz/1/zoom").str(",f").f32(std::numeric_limits<float>::quiet_NaN())).empty());
+
+    // Commands without arguments don't look at the types
+    auto stop = run(Packet().str("/ptz/1/stop").str(",N"));
+    QCOMPARE(stop.size(), std::size_t(1));
+    QCOMPARE(stop[0].kind, osc::Command::Stop);
+}
+
+void TestOsc::bundle()
+{
+    const Packet zoom = Packet().str("/ptz/1/zoom").str(",f").f32(0.25f);
+    const Packet focus = Packet().str("/ptz/3/focus/onepush").str(",");
+    const Packet inner = Packet().str("#bundle").i64(1).packet(focus);
+    bool ok = false;
+    auto cmds = run(Packet().str("#bundle").i64(1).packet(zoom).packet(inner), &ok);
+    QVERIFY(ok);
+    QCOMPARE(cmds.size(), std::size_t(2));
+    QCOMPARE(cmds[0].kind, osc::Command::Zoom);
+    QCOMPARE(cmds[0].zoom, 0.25);
+    QCOMPARE(cmds[1].kind, osc::Command::Focus);
+    QCOMPARE(cmds[1].camera, 3);
+}
+
+void TestOsc::malformed()
+{
+    bool ok = true;
+    Packet truncated = Packet().str("/ptz/1/preset/recall").str(",d").i32(0);
+    QVERIFY(run(truncated, &ok).empty());
+    QVERIFY(!ok);
+
+    Packet array = Packet().str("/ptz/1/zoom").str(",[f]").f32(1.0f);
+    QVERIFY(run(array, &ok).empty());
+    QVERIFY(!ok);
+
+    Packet oversized = Packet().str("#bundle").i64(1).i32(64).str("/ptz/1/stop");
+    QVERIFY(run(oversized, &ok).empty());
+    QVERIFY(!ok);
+}
+
+QTEST_APPLESS_MAIN(TestOsc)
+#include "tst_osc.moc"
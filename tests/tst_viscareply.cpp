@@ -0,0 +1,198 @@
+#include "viscareply.h"
+
+#include <QTest>
+
+using namespace visca;
+
+namespace {
+
+constexpr std::int64_t MS = 1'000'000;
+
+std::uint64_t send(SentFrames &q, const RawFrame &f, std::int64_t nowNs,
+                   std::int64_t timeoutMs = SentFrames::REPLY_TIMEOUT_MS)
+{
+    return q.push(f.bytes.data(), f.size, nowNs, timeoutMs);
+}
+
+RawFrame inquiry(Inquiry i, int address = 1) { return INQUIRY_FRAMES[std::size_t(i)].withAddress(address); }
+
+const RawFrame RECALL = PresetRecall::encode(1, 5);
+
+} // namespace
+
+class TestViscaReply : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void inquiryIsReadFromTheFrame();
+    void repliesPairInSendOrder();
+    void retireByReplyType();
+    void untrackedFrames();
+    void lostReplyIsRetiredByAge();
+    void lostReplyDoesNotShiftLaterPairs();
+    void ackRetiresInquiriesAheadOfCommand();
+    void refusedRetiresOldestFrame();
+    void wrongLengthReplyStaysUnknown();
+};
+
+void TestViscaReply::inquiryIsReadFromTheFrame()
+{
+    QCOMPARE(SentFrames::inquiryOf(inquiry(Inquiry::FocusMode, 3).bytes.data(), 5), Inquiry::FocusMode);
+    QCOMPARE(SentFrames::inquiryOf(inquiry(Inquiry::PanTiltPos).bytes.data(), 5), Inquiry::PanTiltPos);
+    static const Byte unknown[] = {0x81, 0x09, 0x7E, 0x7E, 0x00, 0xFF};
+    QCOMPARE(SentFrames::inquiryOf(unknown, sizeof unknown), Inquiry::None);
+    QCOMPARE(SentFrames::inquiryOf(RECALL.bytes.data(), RECALL.size), Inquiry::None);
+}
+
+void TestViscaReply::repliesPairInSendOrder()
+{
+    SentFrames q;
+    const std::uint64_t power = send(q, inquiry(Inquiry::Power), 0);
+    const std::uint64_t recall = send(q, RECALL, 0);
+    const std::uint64_t zoom = send(q, inquiry(Inquiry::ZoomPos), 0);
+    QCOMPARE(q.size(), 3);
+    QCOMPARE(q.inquiries(), 2);
+
+    SentFrame f = q.answer(10 * MS);
+    QCOMPARE(f.seq, power);
+    QCOMPARE(f.inquiry, Inquiry::Power);
+    QCOMPARE(q.acked(10 * MS).seq, recall);
+    f = q.answer(10 * MS);
+    QCOMPARE(f.seq, zoom);
+    QCOMPARE(f.inquiry, Inquiry::ZoomPos);
+    QVERIFY(q.empty());
+    QVERIFY(!q.answer(10 * MS));
+    QCOMPARE(q.lost(), std::uint64_t(0));
+}
+
+void TestViscaReply::retireByReplyType()
+{
+    static const Byte ack[] = {0x90, 0x41, 0xFF};
+    static const Byte done[] = {0x90, 0x51, 0xFF};
+    static const Byte focusAuto[] = {0x90, 0x50, 0x02, 0xFF};
+    static const Byte refused[] = {0x90, 0x60, 0x03, 0xFF};
+    static const Byte socketError[] = {0x90, 0x61, 0x41, 0xFF};
+    static const Byte broadcast[] = {0x88, 0x30, 0x02, 0xFF};
+
+    SentFrames q;
+    send(q, RECALL, 0);
+    send(q, inquiry(Inquiry::FocusMode), 0);
+    send(q, RECALL, 0);
+
+    // Completions and socket errors answer a command already ACKed
+    QVERIFY(!q.retire(done, sizeof done, MS));
+    QVERIFY(!q.retire(socketError, sizeof socketError, MS));
+    QVERIFY(!q.retire(broadcast, sizeof broadcast, MS));
+    QCOMPARE(q.size(), 3);
+
+    const SentFrame acked = q.retire(ack, sizeof ack, 5 * MS);
+    QCOMPARE(acked.seq, std::uint64_t(1));
+    QVERIFY(!acked.isInquiry);
+    const SentFrame answered = q.retire(focusAuto, sizeof focusAuto, 7 * MS);
+    QCOMPARE(answered.inquiry, Inquiry::FocusMode);
+    QCOMPARE(decode(focusAuto, sizeof focusAuto, answered.inquiry).focusMode, FocusMode::Auto);
+    QCOMPARE(q.retire(refused, sizeof refused, 9 * MS).seq, std::uint64_t(3));
+    QVERIFY(q.empty());
+    QCOMPARE(q.lost(), std::uint64_t(0));
+}
+
+void TestViscaReply::untrackedFrames()
+{
+    // Broadcasts get no reply; a cancel is answered on the socket it cancels
+    SentFrames q;
+    const auto all = inquiry(Inquiry::Power, BROADCAST);
+    QCOMPARE(send(q, all, 0), std::uint64_t(0));
+    const auto cancel = Cancel::encode(1, 2);
+    QCOMPARE(q.push(cancel.bytes.data(), cancel.size(), 0), std::uint64_t(0));
+    QVERIFY(q.empty());
+}
+
+void TestViscaReply::lostReplyIsRetiredByAge()
+{
+    // The camera swallows the power inquiry; its reply never comes. The
+    // focus mode reply that follows is the same length (y0 50 02 FF), so
+    // only the power inquiry's age tells the two apart.
+    SentFrames q;
+    send(q, inquiry(Inquiry::Power), 0);
+    send(q, inquiry(Inquiry::FocusMode), 1500 * MS);
+    QCOMPARE(q.inquiries(), 2);
+
+    const SentFrame answered = q.answer(1600 * MS);
+    QCOMPARE(answered.inquiry, Inquiry::FocusMode);
+    QVERIFY(q.empty());
+    QCOMPARE(q.lost(), std::uint64_t(1));
+
+    static const Byte frame[] = {0x90, 0x50, 0x02, 0xFF};
+    const Reply r = decode(frame, sizeof frame, answered.inquiry);
+    QCOMPARE(r.kind, ReplyKind::InquiryReply);
+    QCOMPARE(r.inquiry, Inquiry::FocusMode);
+    QCOMPARE(r.focusMode, FocusMode::Auto);
+}
+
+void TestViscaReply::lostReplyDoesNotShiftLaterPairs()
+{
+    // Before its deadline a frame is still the head: a reply arriving late
+    // is paired with it, not with the inquiry behind it.
+    SentFrames q;
+    send(q, inquiry(Inquiry::Power), 0, 200);
+    send(q, inquiry(Inquiry::Version), 0);
+    send(q, inquiry(Inquiry::PanTiltPos), 0);
+
+    q.expire(199 * MS);
+    QCOMPARE(q.inquiries(), 3);
+    q.expire(200 * MS);
+    QCOMPARE(q.inquiries(), 2);
+    QCOMPARE(q.lost(), std::uint64_t(1));
+    QCOMPARE(q.answer(250 * MS).inquiry, Inquiry::Version);
+    QCOMPARE(q.answer(250 * MS).inquiry, Inquiry::PanTiltPos);
+}
+
+void TestViscaReply::ackRetiresInquiriesAheadOfCommand()
+{
+    SentFrames q;
+    send(q, inquiry(Inquiry::Power), 0);
+    const std::uint64_t recall = send(q, RECALL, 0);
+    send(q, inquiry(Inquiry::ZoomPos), 0);
+
+    QCOMPARE(q.acked(10 * MS).seq, recall);
+    QCOMPARE(q.lost(), std::uint64_t(1));
+    QCOMPARE(q.inquiries(), 1);
+    QCOMPARE(q.answer(10 * MS).inquiry, Inquiry::ZoomPos);
+
+    // No command outstanding: the ACK isn't ours and nothing is retired.
+    send(q, inquiry(Inquiry::FocusPos), 20 * MS);
+    QVERIFY(!q.acked(30 * MS));
+    QCOMPARE(q.inquiries(), 1);
+    QCOMPARE(q.lost(), std::uint64_t(1));
+}
+
+void TestViscaReply::refusedRetiresOldestFrame()
+{
+    SentFrames q;
+    send(q, RECALL, 0);
+    send(q, inquiry(Inquiry::AeMode), 0);
+
+    QVERIFY(!q.refused(10 * MS).isInquiry);
+    QCOMPARE(q.size(), 1);
+    QCOMPARE(q.refused(10 * MS).inquiry, Inquiry::AeMode);
+    QVERIFY(q.empty());
+
+    // Clearing gives up on whatever is still waiting
+    send(q, RECALL, 20 * MS);
+    q.clear();
+    QVERIFY(q.empty());
+    QCOMPARE(q.lost(), std::uint64_t(1));
+}
+
+void TestViscaReply::wrongLengthReplyStaysUnknown()
+{
+    // A pan/tilt position reply paired with a power inquiry is rejected by
+    // decode(), not silently misread.
+    static const Byte frame[] = {0x90, 0x50, 0x00, 0x00, 0x01, 0x02, 0x0F, 0x0F, 0x0E, 0x0C, 0xFF};
+    const Reply r = decode(frame, sizeof frame, Inquiry::Power);
+    QCOMPARE(r.kind, ReplyKind::Unknown);
+}
+
+QTEST_APPLESS_MAIN(TestViscaReply)
+#include "tst_viscareply.moc"
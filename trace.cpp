@@ -0,0 +1,117 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+struct Event
+{
+    const char   *name;
+    std::uint64_t start;
+    std::uint64_t dur;
+    char          phase;
+};
+
+constexpr std::size_t CAPACITY = 1 << 16; // events per thread, ~1.5 MB
+
+struct ThreadBuffer
+{
+    int tid = 0;
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::size_t> dropped{0};
+    std::unique_ptr<Event[]> events{new Event[CAPACITY]};
+};
+
+// Registration is the only locked step and happens once per thread.
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+ThreadBuffer *localBuffer()
+{
+    thread_local ThreadBuffer *buf = nullptr;
+    if (!buf) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        buf = registry.back().get();
+        buf->tid = int(registry.size());
+    }
+    return buf;
+}
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+void writeEscaped(std::FILE *f, const char *s)
+{
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+}
+
+} // namespace
+
+void detail::record(const char *name, std::uint64_t startNs, std::uint64_t durNs, char phase)
+{
+    ThreadBuffer *b = localBuffer();
+    const std::size_t i = b->count.load(std::memory_order_relaxed);
+    if (i >= CAPACITY) {
+        b->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    b->events[i] = Event{name, startNs, durNs, phase};
+    b->count.store(i + 1, std::memory_order_release);
+}
+
+void setEnabled(bool on)
+{
+    detail::enabled.store(on, std::memory_order_relaxed);
+}
+
+std::uint64_t now()
+{
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - epoch).count());
+}
+
+bool exportChromeJson(const char *path)
+{
+    std::FILE *f = std::fopen(path, "w");
+    if (!f) return false;
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto &b : registry) {
+        const std::size_t n = b->count.load(std::memory_order_acquire);
+        std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                        "\"args\":{\"name\":\"thread %d\"}}",
+                     first ? "" : ",\n", b->tid, b->tid);
+        first = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            const Event &e = b->events[i];
+            std::fputs(",\n{\"name\":\"", f);
+            writeEscaped(f, e.name);
+            // Timestamps are microseconds with ns precision
+            std::fprintf(f, "\",\"cat\":\"ptz\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+                         e.phase, b->tid, double(e.start) / 1000.0);
+            if (e.phase == 'X')
+                std::fprintf(f, ",\"dur\":%.3f", double(e.dur) / 1000.0);
+            else if (e.phase == 'i')
+                std::fputs(",\"s\":\"t\"", f);
+            std::fputc('}', f);
+        }
+        if (const std::size_t d = b->dropped.load(std::memory_order_relaxed))
+            std::fprintf(f, ",\n{\"name\":\"dropped %zu events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,"
+                            "\"tid\":%d,\"ts\":0}", d, b->tid);
+    }
+    std::fputs("\n]}\n", f);
+    return std::fclose(f) == 0;
+}
+
+} // namespace trace
@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Opt-in trace points for the command pipeline, exported as Chrome
+// trace-event JSON (open in https://ui.perfetto.dev or chrome://tracing).
+//
+// Each thread records into its own fixed-size buffer: a single writer bumps
+// a release-ordered count, the exporter reads it with acquire, no locks on
+// the recording path. When tracing is off a trace point costs one relaxed
+// atomic load. Names must be string literals; they are stored by pointer.
+
+#include <atomic>
+#include <cstdint>
+
+namespace trace {
+
+namespace detail {
+inline std::atomic<bool> enabled{false};
+void record(const char *name, std::uint64_t startNs, std::uint64_t durNs, char phase);
+}
+
+inline bool enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool on);
+
+// Monotonic nanoseconds since the first call.
+std::uint64_t now();
+
+// Zero-duration marker ("ph":"i").
+inline void instant(const char *name)
+{
+    if (enabled()) detail::record(name, now(), 0, 'i');
+}
+
+// Complete event ("ph":"X") covering the enclosing scope.
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : n(enabled() ? name : nullptr), start(n ? now() : 0) {}
+    ~Scope() { if (n) detail::record(n, start, now() - start, 'X'); }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *n;
+    std::uint64_t start;
+};
+
+// Writes every recorded event; returns false if the file can't be written.
+bool exportChromeJson(const char *path);
+
+} // namespace trace
+
+#define PTZ_TRACE_CAT2(a, b) a##b
+#define PTZ_TRACE_CAT(a, b)  PTZ_TRACE_CAT2(a, b)
+#define PTZ_TRACE_SCOPE(name) ::trace::Scope PTZ_TRACE_CAT(ptzTraceScope_, __LINE__)(name)
+
+#endif // TRACE_H
@@ -0,0 +1,291 @@
+#ifndef VISCA_H
+#define VISCA_H
+
+// Compile-time VISCA command catalog.
+//
+// Every command is declared once as a layout string plus the valid range of
+// each parameter. Layouts use the notation of the Sony VISCA manuals:
+//
+//   "8x 01 04 3F 02 pp FF"
+//
+//   - digits and upper-case A-F are literal nibbles
+//   - 'x' in the first byte is the camera address (1..7, 8 = broadcast)
+//   - any other lower-case letter is a parameter; repeated letters form one
+//     multi-nibble value, most significant nibble first ("0p 0p 0p 0p")
+//
+// Layouts are parsed and validated at compile time (header/terminator, frame
+// length, parameter count vs. ranges, ranges vs. nibble width). encode()
+// clamps runtime values into range and writes into a fixed-size std::array,
+// so building a frame never allocates and can never produce a stray FF.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace visca {
+
+using Byte = std::uint8_t;
+
+inline constexpr std::size_t MAX_FRAME   = 16;   // VISCA packet limit
+inline constexpr int         BROADCAST   = 8;    // 88 ... FF
+inline constexpr Byte        TERMINATOR  = 0xFF;
+
+struct Range { int min; int max; };
+
+template <std::size_t N>
+struct Frame
+{
+    std::array<Byte, N> bytes{};
+
+    static constexpr std::size_t size() { return N; }
+    const char *data() const { return reinterpret_cast<const char *>(bytes.data()); }
+};
+
+// Type-erased frame for tables holding commands of different lengths.
+struct RawFrame
+{
+    std::array<Byte, MAX_FRAME> bytes{};
+    std::size_t size = 0;
+
+    constexpr RawFrame() = default;
+    template <std::size_t N>
+    constexpr RawFrame(const Frame<N> &f) : size(N)
+    {
+        for (std::size_t i = 0; i < N; ++i) bytes[i] = f.bytes[i];
+    }
+    const char *data() const { return reinterpret_cast<const char *>(bytes.data()); }
+
+    // Table entries are declared for camera 1; retarget the header at send time.
+    constexpr RawFrame withAddress(int address) const
+    {
+        RawFrame f = *this;
+        f.bytes[0] = Byte(0x80 | (address < 1 ? 1 : (address > BROADCAST ? BROADCAST : address)));
+        return f;
+    }
+};
+
+namespace detail {
+
+template <std::size_t N>
+struct Layout
+{
+    char text[N]{};
+    consteval Layout(const char (&s)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i) text[i] = s[i];
+    }
+    static constexpr std::size_t bytes = N / 3; // "XX " per byte, last has NUL
+};
+
+inline constexpr int MAX_PARAMS = 8;
+
+constexpr bool isLiteral(char c) { return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F'); }
+constexpr bool isParam(char c)   { return c >= 'a' && c <= 'z'; }
+constexpr int  hexValue(char c)  { return c <= '9' ? c - '0' : c - 'A' + 10; }
+
+template <std::size_t B>
+struct Spec
+{
+    std::array<Byte, B> fixed{};                 // literal nibbles, params zeroed
+    std::array<std::int8_t, 2 * B> param{};      // per nibble: -1 literal, -2 address, else index
+    std::array<Byte, 2 * B> shift{};             // bit shift of that nibble within its value
+    std::array<char, MAX_PARAMS> names{};
+    std::array<int, MAX_PARAMS> width{};         // nibbles per parameter
+    int params = 0;
+};
+
+// Throwing inside a consteval function turns a malformed layout into a
+// compile error that points at the offending declaration.
+template <std::size_t N>
+consteval Spec<N / 3> parse(const Layout<N> &l)
+{
+    constexpr std::size_t B = N / 3;
+    static_assert(N % 3 == 0, "layout must be space-separated byte pairs");
+    static_assert(B >= 3 && B <= MAX_FRAME, "VISCA frames are 3..16 bytes");
+
+    Spec<B> s;
+    for (std::size_t i = 0; i < B; ++i) {
+        if (i + 1 < B && l.text[3 * i + 2] != ' ') throw "layout bytes must be separated by one space";
+    }
+    if (l.text[0] != '8' || l.text[1] != 'x') throw "layout must start with 8x";
+    if (l.text[3 * (B - 1)] != 'F' || l.text[3 * (B - 1) + 1] != 'F') throw "layout must end with FF";
+
+    // Pass 1: literals, parameter names and widths.
+    for (std::size_t n = 0; n < 2 * B; ++n) {
+        const char c = l.text[3 * (n / 2) + (n % 2)];
+        if (n == 1) { s.param[n] = -2; continue; }
+        if (isLiteral(c)) {
+            s.param[n] = -1;
+            s.fixed[n / 2] |= Byte(hexValue(c) << ((n % 2) ? 0 : 4));
+            continue;
+        }
+        if (!isParam(c) || c == 'x') throw "invalid layout character";
+        int idx = 0;
+        while (idx < s.params && s.names[idx] != c) ++idx;
+        if (idx == s.params) {
+            if (s.params == MAX_PARAMS) throw "too many parameters";
+            s.names[s.params++] = c;
+        }
+        s.param[n] = std::int8_t(idx);
+        ++s.width[idx];
+    }
+    for (std::size_t i = 0; i + 1 < B; ++i) {
+        if (s.param[2 * i] == -1 && s.param[2 * i + 1] == -1 && s.fixed[i] == TERMINATOR)
+            throw "FF only allowed as terminator";
+    }
+    for (int p = 0; p < s.params; ++p)
+        if (s.width[p] > 4) throw "parameters are at most 16 bits";
+
+    // Pass 2: shift of each nibble, most significant first.
+    std::array<int, MAX_PARAMS> seen{};
+    for (std::size_t n = 0; n < 2 * B; ++n) {
+        const int p = s.param[n];
+        if (p < 0) continue;
+        s.shift[n] = Byte(4 * (s.width[p] - 1 - seen[p]++));
+    }
+    return s;
+}
+
+constexpr int clampTo(int v, Range r) { return v < r.min ? r.min : (v > r.max ? r.max : v); }
+
+} // namespace detail
+
+template <detail::Layout L, Range... R>
+struct Command
+{
+    static constexpr auto spec = detail::parse(L);
+    static constexpr std::size_t size = decltype(L)::bytes;
+    static constexpr std::array<Range, sizeof...(R)> ranges{R...};
+    using FrameType = Frame<size>;
+
+    static_assert(sizeof...(R) == std::size_t(spec.params), "one Range per layout parameter");
+    static_assert([] {
+        for (std::size_t p = 0; p < ranges.size(); ++p) {
+            const Range r = ranges[p];
+            const int w = spec.width[p];
+            const int lo = w == 4 ? -0x8000 : 0;           // 16-bit values may be signed
+            const int hi = w == 4 ? 0xFFFF : (1 << (4 * w)) - 1;
+            if (r.min > r.max || r.min < lo || r.max > hi) return false;
+            if (w == 2 && r.max >= TERMINATOR) return false;
+        }
+        return true;
+    }(), "parameter range does not fit its nibbles");
+
+    // Values outside their declared range are clamped, mirroring what the
+    // UI did by hand before; negative values are sent as two's complement.
+    template <typename... Args>
+        requires (sizeof...(Args) == sizeof...(R))
+    static constexpr FrameType encode(int address, Args... args)
+    {
+        const std::array<int, sizeof...(R) + 1> v{detail::clampTo(int(args), R)..., 0};
+        FrameType f;
+        for (std::size_t i = 0; i < size; ++i) f.bytes[i] = spec.fixed[i];
+        f.bytes[0] |= Byte(detail::clampTo(address, {1, BROADCAST}));
+        for (std::size_t n = 2; n < 2 * size; ++n) {
+            const int p = spec.param[n];
+            if (p < 0) continue;
+            const Byte nib = Byte((unsigned(v[p]) >> spec.shift[n]) & 0x0F);
+            f.bytes[n / 2] |= Byte((n % 2) ? nib : nib << 4);
+        }
+        return f;
+    }
+
+    // Compile-time variant: out-of-range constants fail to build instead of
+    // being clamped.
+    template <int... V>
+    static consteval FrameType make(int address)
+    {
+        static_assert(sizeof...(V) == sizeof...(R), "one value per parameter");
+        constexpr std::array<int, sizeof...(V) + 1> v{V..., 0};
+        for (std::size_t p = 0; p < ranges.size(); ++p)
+            if (v[p] < ranges[p].min || v[p] > ranges[p].max) throw "constant out of range";
+        if (address < 1 || address > BROADCAST) throw "address out of range";
+        return encode(address, V...);
+    }
+};
+
+// -------------------- Catalog --------------------
+
+// Direction nibbles shared by Pan-tiltDrive and friends.
+enum PanDir  : int { PAN_LEFT = 1, PAN_RIGHT = 2, PAN_STOP = 3 };
+enum TiltDir : int { TILT_UP  = 1, TILT_DOWN = 2, TILT_STOP = 3 };
+
+// Interface
+using IfClear         = Command<"8x 01 00 01 FF">;
+using AddressSet      = Command<"8x 30 0a FF", Range{1, 7}>;
+using Cancel          = Command<"8x 2p FF", Range{1, 0x0F}>;   // p = socket from the ACK
+
+// Power
+using PowerOn         = Command<"8x 01 04 00 02 FF">;
+using PowerOff        = Command<"8x 01 04 00 03 FF">;
+
+// Zoom: p = speed 0..7
+using ZoomStop        = Command<"8x 01 04 07 00 FF">;
+using ZoomTele        = Command<"8x 01 04 07 2p FF", Range{0, 7}>;
+using ZoomWide        = Command<"8x 01 04 07 3p FF", Range{0, 7}>;
+using ZoomDirect      = Command<"8x 01 04 47 0p 0p 0p 0p FF", Range{0, 0x7AC0}>;
+
+// Focus
+using FocusAuto       = Command<"8x 01 04 38 02 FF">;
+using FocusManual     = Command<"8x 01 04 38 03 FF">;
+using FocusOnePush    = Command<"8x 01 04 18 01 FF">;
+
+// Presets: p = memory number
+using PresetStore     = Command<"8x 01 04 3F 01 pp FF", Range{0, 0x7F}>;
+using PresetRecall    = Command<"8x 01 04 3F 02 pp FF", Range{0, 0x7F}>;
+
+// Pan/tilt: v = pan speed, w = tilt speed, p/q = direction
+using PanTiltDrive    = Command<"8x 01 06 01 vv ww 0p 0q FF",
+                                Range{1, 0x18}, Range{1, 0x17}, Range{1, 3}, Range{1, 3}>;
+using PanTiltHome     = Command<"8x 01 06 04 FF">;
+// v/w = speeds, y = pan, z = tilt (signed, two's complement)
+using PanTiltAbsolute = Command<"8x 01 06 02 vv ww 0y 0y 0y 0y 0z 0z 0z 0z FF",
+                                Range{1, 0x18}, Range{1, 0x17},
+                                Range{-0x7FFF, 0x7FFF}, Range{-0x7FFF, 0x7FFF}>;
+
+// Inquiries
+using PowerInq        = Command<"8x 09 04 00 FF">;
+using VersionInq      = Command<"8x 09 00 02 FF">;
+using ZoomPosInq      = Command<"8x 09 04 47 FF">;
+using FocusModeInq    = Command<"8x 09 04 38 FF">;
+using FocusPosInq     = Command<"8x 09 04 48 FF">;
+using AeModeInq       = Command<"8x 09 04 39 FF">;
+using PanTiltPosInq   = Command<"8x 09 06 12 FF">;
+
+// Inquiry replies carry no socket, so the decoder needs to know which
+// inquiry a payload answers. Values index INQUIRY_FRAMES and the decoder's
+// payload table.
+enum class Inquiry : Byte {
+    None, Power, Version, ZoomPos, FocusMode, FocusPos, AeMode, PanTiltPos,
+    Count
+};
+
+inline constexpr std::array<RawFrame, std::size_t(Inquiry::Count)> INQUIRY_FRAMES{{
+    RawFrame{},
+    PowerInq::make(1),
+    VersionInq::make(1),
+    ZoomPosInq::make(1),
+    FocusModeInq::make(1),
+    FocusPosInq::make(1),
+    AeModeInq::make(1),
+    PanTiltPosInq::make(1),
+}};
+
+// Entries offered in the "Other commands" dropdown.
+struct NamedCommand
+{
+    const char *label;
+    RawFrame    frame;
+};
+
+inline constexpr std::array<NamedCommand, 5> CUSTOM_COMMANDS{{
+    {"Power Inquiry — report ON/OFF (81 09 04 00 FF)",     PowerInq::make(1)},
+    {"Pan/Tilt Home — center position (81 01 06 04 FF)",   PanTiltHome::make(1)},
+    {"AF One-Push — refocus (81 01 04 18 01 FF)",          FocusOnePush::make(1)},
+    {"Focus Auto ON (81 01 04 38 02 FF)",                  FocusAuto::make(1)},
+    {"Focus Auto OFF / Manual (81 01 04 38 03 FF)",        FocusManual::make(1)},
+}};
+
+} // namespace visca
+
+#endif // VISCA_H
@@ -0,0 +1,165 @@
+#include "viscareply.h"
+
+#include <algorithm>
+
+namespace visca {
+
+namespace {
+
+using Handler = void (*)(const Byte *f, std::size_t n, Inquiry q, Reply &r);
+
+// 4-nibble values: 0p 0q 0r 0s
+int nibbles16(const Byte *p)
+{
+    return ((p[0] & 0x0F) << 12) | ((p[1] & 0x0F) << 8) | ((p[2] & 0x0F) << 4) | (p[3] & 0x0F);
+}
+
+int signed16(int v) { return v >= 0x8000 ? v - 0x10000 : v; }
+
+// -------------------- Inquiry payloads (y0 50 ... FF) --------------------
+
+void payloadPower(const Byte *f, Reply &r)     { r.powerOn = f[2] == 0x02; }
+void payloadZoom(const Byte *f, Reply &r)      { r.zoom = nibbles16(f + 2); }
+void payloadFocus(const Byte *f, Reply &r)     { r.focus = nibbles16(f + 2); }
+void payloadAeMode(const Byte *f, Reply &r)    { r.aeMode = AeMode(f[2]); }
+
+void payloadFocusMode(const Byte *f, Reply &r)
+{
+    r.focusMode = f[2] == 0x02 ? FocusMode::Auto : (f[2] == 0x03 ? FocusMode::Manual : FocusMode::Unknown);
+}
+
+void payloadPanTilt(const Byte *f, Reply &r)
+{
+    r.pan  = signed16(nibbles16(f + 2));
+    r.tilt = signed16(nibbles16(f + 6));
+}
+
+// y0 50 GG GG HH HH JJ JJ KK FF
+void payloadVersion(const Byte *f, Reply &r)
+{
+    r.version.vendor  = std::uint16_t((f[2] << 8) | f[3]);
+    r.version.model   = std::uint16_t((f[4] << 8) | f[5]);
+    r.version.rom     = std::uint16_t((f[6] << 8) | f[7]);
+    r.version.sockets = f[8];
+}
+
+struct Payload
+{
+    std::size_t size;                       // whole frame incl. header and FF
+    void (*decode)(const Byte *f, Reply &r);
+};
+
+constexpr std::array<Payload, std::size_t(Inquiry::Count)> PAYLOADS{{
+    {0,  nullptr},              // None
+    {4,  payloadPower},         // Power
+    {10, payloadVersion},       // Version
+    {7,  payloadZoom},          // ZoomPos
+    {4,  payloadFocusMode},     // FocusMode
+    {7,  payloadFocus},         // FocusPos
+    {4,  payloadAeMode},        // AeMode
+    {11, payloadPanTilt},       // PanTiltPos
+}};
+
+// -------------------- Type byte handlers --------------------
+
+void onUnknown(const Byte *, std::size_t, Inquiry, Reply &) {}
+
+void onAck(const Byte *f, std::size_t n, Inquiry, Reply &r)
+{
+    if (n != 3) return;
+    r.kind = ReplyKind::Ack;
+    r.socket = f[1] & 0x0F;
+}
+
+// 50 is shared: "y0 50 FF" completes an addressed IF_Clear, longer frames
+// answer an inquiry, 51..5F complete the command running in that socket.
+void onCompletion(const Byte *f, std::size_t n, Inquiry q, Reply &r)
+{
+    r.socket = f[1] & 0x0F;
+    if (n == 3) {
+        r.kind = ReplyKind::Completion;
+        return;
+    }
+    if (r.socket != 0) return;
+    const Payload &p = PAYLOADS[std::size_t(q)];
+    if (!p.decode || p.size != n) return;
+    r.kind = ReplyKind::InquiryReply;
+    r.inquiry = q;
+    p.decode(f, r);
+}
+
+void onError(const Byte *f, std::size_t n, Inquiry, Reply &r)
+{
+    if (n != 4) return;
+    r.kind = ReplyKind::Error;
+    r.socket = f[1] & 0x0F;
+    switch (f[2]) {
+    case 0x01: case 0x02: case 0x03: case 0x04: case 0x05: case 0x41:
+        r.error = ErrorKind(f[2]);
+        break;
+    default:
+        r.error = ErrorKind::Other;
+        break;
+    }
+}
+
+void onAddressSet(const Byte *f, std::size_t n, Inquiry, Reply &r)
+{
+    if (n != 4) return;
+    r.kind = ReplyKind::AddressSet;
+    r.socket = f[2]; // next free address, i.e. camera count + 1
+}
+
+void onNetworkChange(const Byte *, std::size_t n, Inquiry, Reply &r)
+{
+    if (n == 3) r.kind = ReplyKind::NetworkChange;
+}
+
+void onIfClear(const Byte *f, std::size_t n, Inquiry, Reply &r)
+{
+    if (n == 5 && f[2] == 0x00 && f[3] == 0x01) r.kind = ReplyKind::IfClear;
+}
+
+constexpr std::array<Handler, 256> makeTypeTable()
+{
+    std::array<Handler, 256> t{};
+    for (auto &h : t) h = onUnknown;
+    for (int z = 0; z < 16; ++z) {
+        t[0x40 | z] = onAck;
+        t[0x50 | z] = onCompletion;
+        t[0x60 | z] = onError;
+    }
+    t[0x01] = onIfClear;
+    t[0x30] = onAddressSet;
+    t[0x38] = onNetworkChange;
+    return t;
+}
+
+constexpr std::array<Handler, 256> BY_TYPE = makeTypeTable();
+
+} // namespace
+
+Inquiry SentFrames::inquiryOf(const Byte *frame, std::size_t size)
+{
+    if (size < 3 || frame[1] != 0x09) return Inquiry::None;
+    for (std::size_t q = 1; q < INQUIRY_FRAMES.size(); ++q) {
+        const RawFrame &f = INQUIRY_FRAMES[q];
+        if (f.size == size && std::equal(f.bytes.begin() + 1, f.bytes.begin() + std::ptrdiff_t(size), frame + 1))
+            return Inquiry(q);
+    }
+    return Inquiry::None;
+}
+
+Reply decode(const Byte *frame, std::size_t size, Inquiry outstanding)
+{
+    Reply r;
+    if (size < 3 || size > MAX_FRAME || frame[size - 1] != TERMINATOR || !(frame[0] & 0x80))
+        return r;
+    if (std::size_t(outstanding) >= PAYLOADS.size()) outstanding = Inquiry::None;
+    r.address = (frame[0] >> 4) & 0x07;
+    if (frame[0] == 0x88) r.address = BROADCAST;
+    BY_TYPE[frame[1]](frame, size, outstanding, r);
+    return r;
+}
+
+} // namespace visca
@@ -0,0 +1,248 @@
+#ifndef VISCAREPLY_H
+#define VISCAREPLY_H
+
+// Table-driven decoder for VISCA replies.
+//
+// decode() dispatches on the type byte (ACK 4z, completion 5z, error 6z,
+// address set, network change, IF_Clear) through a 256-entry table built at
+// compile time. Inquiry replies share the 50 type byte, so their payload is
+// decoded through a second table indexed by the inquiry that was outstanding.
+// Nothing here allocates or formats text; see MainWindow::describeReply for
+// the log annotation.
+
+#include "visca.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace visca {
+
+enum class ReplyKind : Byte {
+    Unknown,        // malformed or unexpected frame
+    Ack,            // y0 4z FF
+    Completion,     // y0 5z FF
+    Error,          // y0 6z ee FF
+    InquiryReply,   // y0 50 <payload> FF, see inquiry
+    AddressSet,     // 88 30 0w FF
+    NetworkChange,  // x0 38 FF
+    IfClear,        // 88 01 00 01 FF
+};
+
+enum class ErrorKind : Byte {
+    None          = 0x00,
+    MessageLength = 0x01,
+    Syntax        = 0x02,
+    BufferFull    = 0x03,
+    Cancelled     = 0x04,
+    NoSocket      = 0x05,
+    NotExecutable = 0x41,
+    Other         = 0xFF,
+};
+
+enum class FocusMode : Byte { Unknown, Auto, Manual };
+
+enum class AeMode : Byte {
+    FullAuto   = 0x00,
+    Manual     = 0x03,
+    Shutter    = 0x0A,
+    Iris       = 0x0B,
+    Bright     = 0x0D,
+    Unknown    = 0xFF,
+};
+
+struct Version
+{
+    std::uint16_t vendor = 0;
+    std::uint16_t model = 0;
+    std::uint16_t rom = 0;
+    Byte sockets = 0;
+};
+
+struct Reply
+{
+    ReplyKind kind = ReplyKind::Unknown;
+    Byte      address = 0;              // replying camera, 1..7 (8 = broadcast)
+    Byte      socket = 0;
+    ErrorKind error = ErrorKind::None;
+    Inquiry   inquiry = Inquiry::None;  // set for InquiryReply
+
+    // Inquiry payloads; only the member matching `inquiry` is meaningful.
+    bool          powerOn = false;
+    int           zoom = 0;             // 0x0000..0x4000 (optical)
+    int           focus = 0;
+    FocusMode     focusMode = FocusMode::Unknown;
+    AeMode        aeMode = AeMode::Unknown;
+    int           pan = 0;              // signed, camera units
+    int           tilt = 0;
+    Version       version;
+};
+
+Reply decode(const Byte *frame, std::size_t size, Inquiry outstanding);
+
+// A sent frame as SentFrames tracks it.
+struct SentFrame
+{
+    std::uint64_t seq = 0;                  // from 1 in send order; 0 = no frame
+    bool          isInquiry = false;        // 8x 09 ...; a command otherwise
+    Inquiry       inquiry = Inquiry::None;  // which one, if it is a known inquiry
+    std::int64_t  sentNs = 0;               // SentFrames::now() time base
+    std::int64_t  deadlineNs = 0;
+    explicit operator bool() const { return seq != 0; }
+};
+
+// The frames sent on one link that still wait for their first reply, in
+// send order. It is the one place replies are paired with frames: the
+// inquiry a 50 reply decodes as, the send time LinkStats measures latency
+// from and the frame CameraClient learns the socket of all come from the
+// SentFrame that retire() hands back.
+//
+// Cameras answer frames in the order they arrived: a command with an ACK or
+// a socket-0 error, an inquiry with its 50 reply or a socket-0 error. So an
+// ACK retires the oldest command, a 50 reply the oldest inquiry, and a
+// socket-0 error whatever was sent first; frames skipped on the way lost
+// their replies. Broadcasts get no reply and cancels are answered on the
+// socket they cancel, so neither is tracked.
+//
+// Replies never carry what they answer, so a swallowed reply is noticed by
+// age alone: a frame still unanswered at its deadline is dropped before the
+// next reply is paired, rather than taking a later frame's answer.
+class SentFrames
+{
+public:
+    static constexpr std::int64_t REPLY_TIMEOUT_MS = 1000;
+
+    // Steady clock in nanoseconds, the time base of the calls below.
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static bool expectsReply(const Byte *frame, std::size_t size)
+    {
+        return size >= 3 && frame[0] != 0x88 && (frame[1] & 0xF0) != 0x20;
+    }
+    // The known inquiry `frame` asks, whatever its address; None otherwise.
+    static Inquiry inquiryOf(const Byte *frame, std::size_t size);
+
+    bool empty() const { return count == 0; }
+    int  size() const { return count; }
+    // Inquiries only; commands don't count towards the inquiry window.
+    int  inquiries() const { return inquiryCount; }
+    // Frames given up unanswered: past their deadline, pushed out or cleared.
+    std::uint64_t lost() const { return lostCount; }
+
+    // Returns the frame's seq, 0 when it expects no reply. Lost once
+    // `timeoutMs` pass without one.
+    std::uint64_t push(const Byte *frame, std::size_t size, std::int64_t nowNs = now(),
+                       std::int64_t timeoutMs = REPLY_TIMEOUT_MS)
+    {
+        if (!expectsReply(frame, size)) return 0;
+        if (count == int(items.size())) { ++lostCount; pop(); }   // oldest reply was lost
+        SentFrame f;
+        f.seq = nextSeq++;
+        f.isInquiry = frame[1] == 0x09;
+        f.inquiry = f.isInquiry ? inquiryOf(frame, size) : Inquiry::None;
+        f.sentNs = nowNs;
+        f.deadlineNs = nowNs + timeoutMs * 1'000'000;
+        items[(head + std::size_t(count++)) % items.size()] = f;
+        if (f.isInquiry) ++inquiryCount;
+        return f.seq;
+    }
+
+    // Pairs a received frame with the sent frame it answers and retires it;
+    // an empty SentFrame for completions, socket errors and anything else
+    // that answers no frame.
+    SentFrame retire(const Byte *reply, std::size_t size, std::int64_t nowNs = now())
+    {
+        if (size < 3 || reply[0] == 0x88) return {};
+        const Byte type = reply[1];
+        if ((type & 0xF0) == 0x40) return acked(nowNs);
+        if (type == 0x50 && size > 3) return answer(nowNs);
+        if (type == 0x60) return refused(nowNs);
+        return {};
+    }
+
+    // 4z ACK: the oldest command got its socket. Inquiries ahead of it lost
+    // their replies; if no command is outstanding the ACK isn't ours.
+    SentFrame acked(std::int64_t nowNs = now())
+    {
+        expire(nowNs);
+        int n = 0;
+        while (n < count && at(n).isInquiry) ++n;
+        return n == count ? SentFrame{} : take(n);
+    }
+
+    // 50 reply: the oldest inquiry still waiting. Commands ahead of it lost
+    // their ACKs.
+    SentFrame answer(std::int64_t nowNs = now())
+    {
+        expire(nowNs);
+        int n = 0;
+        while (n < count && !at(n).isInquiry) ++n;
+        return n == count ? SentFrame{} : take(n);
+    }
+
+    // Socket-0 error: the oldest frame was refused, command or inquiry.
+    SentFrame refused(std::int64_t nowNs = now())
+    {
+        expire(nowNs);
+        return count ? take(0) : SentFrame{};
+    }
+
+    // Drops every frame whose deadline has passed.
+    void expire(std::int64_t nowNs = now())
+    {
+        int kept = 0;
+        for (int i = 0; i < count; ++i) {
+            const SentFrame f = at(i);
+            if (f.deadlineNs <= nowNs) {
+                ++lostCount;
+                if (f.isInquiry) --inquiryCount;
+                continue;
+            }
+            items[(head + std::size_t(kept++)) % items.size()] = f;
+        }
+        count = kept;
+    }
+
+    // Nothing sent so far will be answered, e.g. after a reconnect.
+    void clear()
+    {
+        lostCount += std::uint64_t(count);
+        head = 0;
+        count = 0;
+        inquiryCount = 0;
+    }
+
+private:
+    const SentFrame &at(int i) const { return items[(head + std::size_t(i)) % items.size()]; }
+    void pop()
+    {
+        if (at(0).isInquiry) --inquiryCount;
+        head = (head + 1) % items.size();
+        --count;
+    }
+    // Retires frame `n`; the `n` sent before it are lost.
+    SentFrame take(int n)
+    {
+        lostCount += std::uint64_t(n);
+        for (int i = 0; i < n; ++i) pop();
+        const SentFrame f = at(0);
+        pop();
+        return f;
+    }
+
+    std::array<SentFrame, 64> items{};
+    std::size_t   head = 0;
+    int           count = 0;
+    int           inquiryCount = 0;
+    std::uint64_t lostCount = 0;
+    std::uint64_t nextSeq = 1;
+};
+
+} // namespace visca
+
+#endif // VISCAREPLY_H
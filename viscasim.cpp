@@ -0,0 +1,255 @@
+#include "viscasim.h"
+
+#include <QTimer>
+
+#include <algorithm>
+#include <initializer_list>
+
+#if defined(Q_OS_UNIX)
+#include <QSocketNotifier>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// Full-speed motion rates, roughly an EVI-D70
+static const double PAN_RATE  = 1000.0;   // units/s at speed 0x18
+static const double TILT_RATE = 1000.0;   // units/s at speed 0x14
+static const double ZOOM_RATE = 4000.0;   // units/s at speed 7
+static const int    ABSOLUTE_MS = 200;    // absolute moves complete after this
+
+static QByteArray bytes(std::initializer_list<int> v)
+{
+    QByteArray out;
+    for (int c : v) out.append(char(c));
+    return out;
+}
+
+static QByteArray nibbles(int v, int count)
+{
+    QByteArray out;
+    for (int i = count - 1; i >= 0; --i) out.append(char((v >> (4 * i)) & 0x0F));
+    return out;
+}
+
+ViscaSimulator::ViscaSimulator(const Options &o, QObject *parent)
+    : QObject(parent), opt(o)
+{
+    clock.start();
+}
+
+ViscaSimulator::~ViscaSimulator()
+{
+    close();
+}
+
+#if defined(Q_OS_UNIX)
+
+bool ViscaSimulator::open()
+{
+    close();
+    const int fd = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0) return false;
+    if (::grantpt(fd) != 0 || ::unlockpt(fd) != 0) {
+        ::close(fd);
+        return false;
+    }
+    const char *name = ::ptsname(fd);
+    if (!name) {
+        ::close(fd);
+        return false;
+    }
+
+    // Raw slave so no byte of a frame is ever translated (0x0D, 0x11, ...)
+    const int slave = ::open(name, O_RDWR | O_NOCTTY);
+    if (slave >= 0) {
+        termios t{};
+        if (::tcgetattr(slave, &t) == 0) {
+            ::cfmakeraw(&t);
+            ::tcsetattr(slave, TCSANOW, &t);
+        }
+        ::close(slave);
+    }
+
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    masterFd = fd;
+    slavePath = QString::fromLocal8Bit(name);
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &ViscaSimulator::onReadable);
+    return true;
+}
+
+void ViscaSimulator::close()
+{
+    if (masterFd < 0) return;
+    delete notifier;
+    notifier = nullptr;
+    ::close(masterFd);
+    masterFd = -1;
+    slavePath.clear();
+    inBuf.clear();
+}
+
+void ViscaSimulator::onReadable()
+{
+    char buf[512];
+    while (true) {
+        const ssize_t n = ::read(masterFd, buf, sizeof buf);
+        if (n <= 0) break;   // EAGAIN, or EIO while the app has the port closed
+        inBuf.append(buf, qsizetype(n));
+    }
+    qsizetype start = 0;
+    while (true) {
+        const qsizetype end = inBuf.indexOf(char(0xFF), start);
+        if (end < 0) break;
+        handleFrame(inBuf.mid(start, end - start + 1));
+        start = end + 1;
+    }
+    if (start > 0) inBuf.remove(0, start);
+}
+
+void ViscaSimulator::reply(const QByteArray &f, int delayMs)
+{
+    auto write = [this, f] {
+        if (masterFd < 0) return;
+        // A full pty means the app stopped reading; drop like a real line would
+        (void)::write(masterFd, f.constData(), size_t(f.size()));
+    };
+    if (delayMs <= 0) write();
+    else QTimer::singleShot(delayMs, this, write);
+}
+
+#else // no pty: soak runs need a POSIX system
+
+bool ViscaSimulator::open() { return false; }
+void ViscaSimulator::close() {}
+void ViscaSimulator::onReadable() {}
+void ViscaSimulator::reply(const QByteArray &, int) {}
+
+#endif
+
+void ViscaSimulator::complete(int socket, int delayMs)
+{
+    const int hdr = 0x80 | ((opt.address + 8) << 4);
+    QTimer::singleShot(delayMs, this, [this, socket, hdr] {
+        busySockets &= ~(1u << (socket - 1));
+        ++count.completions;
+        reply(bytes({hdr, 0x50 | socket, 0xFF}), 0);
+    });
+}
+
+void ViscaSimulator::advance()
+{
+    const qint64 now = clock.elapsed();
+    const double dt = double(now - lastMs) / 1000.0;
+    lastMs = now;
+    pan  = std::clamp(pan  + panV  * dt, -double(0x7000), double(0x7000));
+    tilt = std::clamp(tilt + tiltV * dt, -double(0x7000), double(0x7000));
+    zoom = std::clamp(zoom + zoomV * dt, 0.0, double(0x4000));
+}
+
+void ViscaSimulator::handleFrame(const QByteArray &f)
+{
+    ++count.framesIn;
+    if (f.size() < 3) return;
+    const auto b = [&](int i) { return i < f.size() ? quint8(f[i]) : quint8(0); };
+    const int to = b(0) & 0x0F;
+    if ((b(0) & 0xF0) != 0x80 || (to != opt.address && to != 8)) return;
+
+    const QByteArray head(1, char(0x80 | ((opt.address + 8) << 4)));
+
+    // Broadcasts: IF_Clear and AddressSet
+    if (to == 8) {
+        if (b(1) == 0x01 && b(2) == 0x00 && b(3) == 0x01)
+            reply(QByteArray("\x88\x01\x00\x01\xFF", 5), opt.replyDelayMs);
+        else if (b(1) == 0x30)
+            reply(bytes({0x88, 0x30, b(2) + 1, 0xFF}), opt.replyDelayMs);
+        return;
+    }
+
+    if (opt.errorRate > 0 && rng.generateDouble() < opt.errorRate) {
+        ++count.injectedErrors;
+        reply(head + QByteArray("\x60\x02\xFF", 3), opt.replyDelayMs);
+        return;
+    }
+
+    // Cancel: 8x 2p FF
+    if ((b(1) & 0xF0) == 0x20) {
+        const int s = b(1) & 0x0F;
+        const bool busy = s >= 1 && s <= opt.sockets && (busySockets & (1u << (s - 1)));
+        if (busy) busySockets &= ~(1u << (s - 1));
+        reply(head + bytes({0x60 | s, busy ? 0x04 : 0x05, 0xFF}), opt.replyDelayMs);
+        return;
+    }
+
+    advance();
+
+    // Inquiries: answered at once, no socket
+    if (b(1) == 0x09) {
+        QByteArray payload;
+        const int cat = b(2), item = b(3);
+        if (cat == 0x04 && item == 0x00)      payload = bytes({power ? 0x02 : 0x03});
+        else if (cat == 0x00 && item == 0x02) payload = QByteArray("\x00\x01\x04\x0E\x01\x00\x02", 7);
+        else if (cat == 0x04 && item == 0x47) payload = nibbles(int(zoom), 4);
+        else if (cat == 0x04 && item == 0x38) payload = bytes({0x02});
+        else if (cat == 0x04 && item == 0x48) payload = nibbles(0x1000, 4);
+        else if (cat == 0x04 && item == 0x39) payload = bytes({0x00});
+        else if (cat == 0x06 && item == 0x12) payload = nibbles(int(pan), 4) + nibbles(int(tilt), 4);
+        if (payload.isEmpty()) {
+            reply(head + QByteArray("\x60\x02\xFF", 3), opt.replyDelayMs);
+            return;
+        }
+        ++count.inquiryReplies;
+        reply(head + char(0x50) + payload + char(0xFF), opt.replyDelayMs);
+        return;
+    }
+
+    if (b(1) != 0x01) {
+        reply(head + QByteArray("\x60\x02\xFF", 3), opt.replyDelayMs);
+        return;
+    }
+
+    // Commands take a socket until completion
+    int socket = 0;
+    for (int s = 1; s <= opt.sockets; ++s)
+        if (!(busySockets & (1u << (s - 1)))) { socket = s; break; }
+    if (!socket) {
+        ++count.bufferFull;
+        reply(head + QByteArray("\x60\x03\xFF", 3), opt.replyDelayMs);
+        return;
+    }
+    busySockets |= 1u << (socket - 1);
+    ++count.acks;
+    reply(head + bytes({0x40 | socket, 0xFF}), opt.replyDelayMs);
+
+    int doneMs = opt.replyDelayMs;
+    const int cat = b(2), cmd = b(3);
+    if (cat == 0x04 && cmd == 0x00) {
+        power = b(4) == 0x02;
+    } else if (cat == 0x04 && cmd == 0x07) {
+        const int p = b(4);
+        zoomV = (p & 0xF0) == 0x20 ?  ZOOM_RATE * ((p & 0x0F) + 1) / 8
+              : (p & 0xF0) == 0x30 ? -ZOOM_RATE * ((p & 0x0F) + 1) / 8 : 0;
+    } else if (cat == 0x04 && cmd == 0x47) {
+        zoom = (b(4) << 12) | (b(5) << 8) | (b(6) << 4) | b(7);
+        zoomV = 0;
+    } else if (cat == 0x04 && cmd == 0x3F && b(4) == 0x02) {
+        panV = tiltV = zoomV = 0;
+        doneMs += opt.recallMs;
+    } else if (cat == 0x06 && cmd == 0x01) {
+        const int pd = b(6), td = b(7);
+        panV  = pd == 1 ? -PAN_RATE  * b(4) / 0x18 : pd == 2 ? PAN_RATE  * b(4) / 0x18 : 0;
+        tiltV = td == 1 ?  TILT_RATE * b(5) / 0x14 : td == 2 ? -TILT_RATE * b(5) / 0x14 : 0;
+    } else if (cat == 0x06 && cmd == 0x02) {
+        pan  = qint16((b(6) << 12) | (b(7) << 8) | (b(8) << 4) | b(9));
+        tilt = qint16((b(10) << 12) | (b(11) << 8) | (b(12) << 4) | b(13));
+        panV = tiltV = 0;
+        doneMs += ABSOLUTE_MS;
+    } else if (cat == 0x06 && cmd == 0x04) {
+        pan = tilt = panV = tiltV = 0;
+        doneMs += ABSOLUTE_MS;
+    }
+    complete(socket, doneMs);
+}
@@ -0,0 +1,74 @@
+#ifndef VISCASIM_H
+#define VISCASIM_H
+
+// A simulated VISCA camera behind a pseudo-terminal, for soak runs.
+//
+// open() creates a pty pair; the app connects to devicePath() exactly as it
+// would to a real serial port, so the whole QSerialPort -> sendVisca ->
+// processIncomingFrames path is exercised. The camera ACKs each command
+// after replyDelayMs, completes it after its motion time, answers the
+// inquiries in visca.h from a moving model of pan/tilt/zoom, and can inject
+// buffer-full and syntax errors. POSIX only; open() fails elsewhere.
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QString>
+
+class QSocketNotifier;
+
+class ViscaSimulator : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options {
+        int    address      = 1;
+        int    replyDelayMs = 2;      // frame in -> ACK / inquiry reply
+        int    recallMs     = 300;    // preset recall completion time
+        int    sockets      = 2;      // command buffers, as on Sony cameras
+        double errorRate    = 0.0;    // chance a frame is answered with a syntax error
+    };
+
+    struct Counters {
+        quint64 framesIn = 0;
+        quint64 acks = 0;
+        quint64 completions = 0;
+        quint64 inquiryReplies = 0;
+        quint64 bufferFull = 0;
+        quint64 injectedErrors = 0;
+    };
+
+    explicit ViscaSimulator(const Options &opt, QObject *parent = nullptr);
+    ~ViscaSimulator() override;
+
+    bool open();
+    void close();
+    QString devicePath() const { return slavePath; }
+    const Counters &counters() const { return count; }
+
+private:
+    void onReadable();
+    void handleFrame(const QByteArray &f);
+    void reply(const QByteArray &f, int delayMs);
+    void complete(int socket, int delayMs);
+    void advance();   // integrate pan/tilt/zoom motion up to now
+
+    Options opt;
+    Counters count;
+    int masterFd = -1;
+    QString slavePath;
+    QSocketNotifier *notifier{};
+    QByteArray inBuf;
+    QRandomGenerator rng{0x5054};
+    QElapsedTimer clock;
+    quint32 busySockets = 0;          // bit n = socket n+1 executing
+
+    // Camera model: speeds in units/s, positions in camera units
+    bool   power = true;
+    double pan = 0, tilt = 0, zoom = 0;
+    double panV = 0, tiltV = 0, zoomV = 0;
+    qint64 lastMs = 0;
+};
+
+#endif // VISCASIM_H